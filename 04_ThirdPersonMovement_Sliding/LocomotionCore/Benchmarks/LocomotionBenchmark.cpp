@@ -0,0 +1,297 @@
+// Microbenchmark for the locomotion core.
+// Reports ns per character per tick for walk, sprint, flat slide, downhill slide and airborne slide,
+// then the cost of slide substepping at common tick rates and at the 10-20 Hz tick LOD rates,
+// and the crowd tick with settings copied into every character vs one shared tuning.
+
+#include "LocomotionCore.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <set>
+#include <vector>
+
+namespace
+{
+	struct FScenario
+	{
+		const char* Name;
+		bool bSliding;
+		bool bRunning;
+		bool bGrounded;
+		bool bHasGroundHit;
+		FLocomotionVector GroundNormal;
+	};
+
+	volatile float GSink = 0.f;
+
+	// Spread headings so slides are not all identical. On a slope they stay within 60 degrees of straight downhill
+	FLocomotionVector MakeForward(int Index, const FLocomotionVector& GroundNormal)
+	{
+		const float Spread = static_cast<float>(Index) * 0.0174533f;
+		const bool bSloped = GroundNormal.X != 0.f || GroundNormal.Y != 0.f;
+		const float Yaw = bSloped ? std::atan2(GroundNormal.Y, GroundNormal.X) + std::fmod(Spread, 2.0944f) - 1.0472f : Spread;
+		return FLocomotionVector(std::cos(Yaw), std::sin(Yaw), 0.f);
+	}
+
+	double RunScenario(const FScenario& Scenario, const FLocomotionSettings& Settings, int NumCharacters, int NumFrames)
+	{
+		const float DeltaTime = 1.f / 60.f;
+
+		std::vector<FLocomotionState> States(NumCharacters);
+		std::vector<FLocomotionTickInput> Inputs(NumCharacters);
+
+		for (int Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FLocomotionVector Forward = MakeForward(Index, Scenario.GroundNormal);
+
+			FLocomotionState& State = States[Index];
+			State.bIsRunning = Scenario.bRunning;
+			State.MovementInput.Y = 1.f;
+			if (Scenario.bSliding)
+			{
+				Locomotion::StartSlide(State, Settings, Forward);
+			}
+
+			FLocomotionTickInput& Input = Inputs[Index];
+			Input.DeltaTime = DeltaTime;
+			Input.bIsGrounded = Scenario.bGrounded;
+			Input.bIsFalling = !Scenario.bGrounded;
+			Input.ActorForward = Forward;
+			Input.bHasSlideGroundHit = Scenario.bHasGroundHit;
+			Input.SlideGroundNormal = Scenario.GroundNormal;
+		}
+
+		FLocomotionTickOutput Output;
+		float Accumulator = 0.f;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int Index = 0; Index < NumCharacters; ++Index)
+			{
+				FLocomotionState& State = States[Index];
+
+				// Keep the slide alive for the whole run so every frame measures the slide path
+				if (Scenario.bSliding)
+				{
+					State.SlideStartTimer = 1.f;
+				}
+
+				Locomotion::Tick(State, Settings, Inputs[Index], Output);
+
+				float MaxWalkSpeed = Output.MaxWalkSpeed;
+				Locomotion::ResolveMaxWalkSpeed(State, Settings, State.MovementInput.Y, MaxWalkSpeed);
+				Accumulator += Output.SlideMoveScale + MaxWalkSpeed;
+			}
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		GSink = Accumulator;
+
+		const double Nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count());
+		return Nanoseconds / (static_cast<double>(NumCharacters) * NumFrames);
+	}
+
+	struct FSubstepResult
+	{
+		double NsPerTick;
+		double NsPerSecond;
+		float MeanSlideSpeed;
+	};
+
+	// Slides for one simulated second on a ramp at TickRate, integrating at StepRate (0 = once per tick)
+	FSubstepResult RunSubstepScenario(FLocomotionSettings Settings, float TickRate, float StepRate, const FLocomotionVector& GroundNormal, int NumCharacters)
+	{
+		Settings.SlideFixedStepRate = StepRate;
+		Settings.SlideStartGraceTime = 2.f;
+
+		const float DeltaTime = 1.f / TickRate;
+		const int NumFrames = static_cast<int>(TickRate + 0.5f);
+
+		std::vector<FLocomotionState> States(NumCharacters);
+		std::vector<FLocomotionTickInput> Inputs(NumCharacters);
+
+		for (int Index = 0; Index < NumCharacters; ++Index)
+		{
+			const FLocomotionVector Forward = MakeForward(Index, GroundNormal);
+
+			FLocomotionState& State = States[Index];
+			State.bIsRunning = true;
+			State.MovementInput.Y = 1.f;
+			Locomotion::StartSlide(State, Settings, Forward);
+
+			FLocomotionTickInput& Input = Inputs[Index];
+			Input.DeltaTime = DeltaTime;
+			Input.bIsGrounded = true;
+			Input.ActorForward = Forward;
+			Input.bHasSlideGroundHit = true;
+			Input.SlideGroundNormal = GroundNormal;
+		}
+
+		FLocomotionTickOutput Output;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int Index = 0; Index < NumCharacters; ++Index)
+			{
+				Locomotion::Tick(States[Index], Settings, Inputs[Index], Output);
+			}
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		float SpeedSum = 0.f;
+		for (const FLocomotionState& State : States)
+		{
+			SpeedSum += State.SlideVelocity.Size();
+		}
+		GSink = SpeedSum;
+
+		const double Nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count());
+		return { Nanoseconds / (static_cast<double>(NumCharacters) * NumFrames), Nanoseconds / NumCharacters, SpeedSum / NumCharacters };
+	}
+
+	// Distance between two characters' settings when each actor carries its own copy, roughly one actor allocation
+	constexpr size_t ActorStride = 2048;
+	constexpr size_t CacheLineSize = 64;
+
+	struct FLayoutResult
+	{
+		double NsPerTick;
+		double CacheLinesPerCharacter;
+	};
+
+	// Ticks a sliding crowd through a settings pointer per character, like ULocomotionSubsystem's pass.
+	// With bSharedTuning every pointer is the same settings, otherwise each points into its own actor-sized block
+	FLayoutResult RunLayoutScenario(bool bSharedTuning, const FLocomotionVector& GroundNormal, int NumCharacters, int NumFrames)
+	{
+		const FLocomotionSettings Shared;
+		std::vector<uint8_t> ActorBlocks(bSharedTuning ? 0 : NumCharacters * ActorStride + CacheLineSize);
+
+		std::vector<FLocomotionState> States(NumCharacters);
+		std::vector<FLocomotionTickInput> Inputs(NumCharacters);
+		std::vector<const FLocomotionSettings*> Settings(NumCharacters);
+
+		for (int Index = 0; Index < NumCharacters; ++Index)
+		{
+			// Settings sit at an arbitrary member offset inside the actor, not on a line boundary
+			Settings[Index] = bSharedTuning ? &Shared : new (&ActorBlocks[Index * ActorStride + 40]) FLocomotionSettings();
+
+			const FLocomotionVector Forward = MakeForward(Index, GroundNormal);
+
+			FLocomotionState& State = States[Index];
+			State.bIsRunning = true;
+			State.MovementInput.Y = 1.f;
+			Locomotion::StartSlide(State, *Settings[Index], Forward);
+
+			FLocomotionTickInput& Input = Inputs[Index];
+			Input.DeltaTime = 1.f / 60.f;
+			Input.bIsGrounded = true;
+			Input.ActorForward = Forward;
+			Input.bHasSlideGroundHit = true;
+			Input.SlideGroundNormal = GroundNormal;
+		}
+
+		// Distinct lines of state and settings one tick reads, the proxy for cache misses once the crowd outgrows the cache
+		std::set<uintptr_t> Lines;
+		for (int Index = 0; Index < NumCharacters; ++Index)
+		{
+			const uintptr_t StateAddress = reinterpret_cast<uintptr_t>(&States[Index]);
+			const uintptr_t SettingsAddress = reinterpret_cast<uintptr_t>(Settings[Index]);
+			for (uintptr_t Line = StateAddress / CacheLineSize; Line <= (StateAddress + sizeof(FLocomotionState) - 1) / CacheLineSize; ++Line)
+			{
+				Lines.insert(Line);
+			}
+			for (uintptr_t Line = SettingsAddress / CacheLineSize; Line <= (SettingsAddress + sizeof(FLocomotionSettings) - 1) / CacheLineSize; ++Line)
+			{
+				Lines.insert(Line);
+			}
+		}
+
+		FLocomotionTickOutput Output;
+		float Accumulator = 0.f;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (int Index = 0; Index < NumCharacters; ++Index)
+			{
+				FLocomotionState& State = States[Index];
+				State.SlideStartTimer = 1.f;
+				Locomotion::Tick(State, *Settings[Index], Inputs[Index], Output);
+				Accumulator += Output.SlideMoveScale;
+			}
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		GSink = Accumulator;
+
+		const double Nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count());
+		return { Nanoseconds / (static_cast<double>(NumCharacters) * NumFrames), static_cast<double>(Lines.size()) / NumCharacters };
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	const int NumCharacters = Argc > 1 ? std::atoi(Argv[1]) : 4096;
+	const int NumFrames = Argc > 2 ? std::atoi(Argv[2]) : 600;
+
+	const FLocomotionSettings Settings;
+
+	// 20 degree ramp, normal leaning towards -X
+	const float RampAngle = 20.f * LocomotionMath::Pi / 180.f;
+	const FLocomotionVector RampNormal(-std::sin(RampAngle), 0.f, std::cos(RampAngle));
+
+	const FScenario Scenarios[] =
+	{
+		{ "walk",           false, false, true,  false, FLocomotionVector::Up() },
+		{ "sprint",         false, true,  true,  false, FLocomotionVector::Up() },
+		{ "slide_flat",     true,  true,  true,  true,  FLocomotionVector::Up() },
+		{ "slide_downhill", true,  true,  true,  true,  RampNormal },
+		{ "slide_airborne", true,  true,  false, false, FLocomotionVector::Up() },
+	};
+
+	std::printf("LocomotionBenchmark: %d characters, %d frames\n", NumCharacters, NumFrames);
+	for (const FScenario& Scenario : Scenarios)
+	{
+		const double NsPerTick = RunScenario(Scenario, Settings, NumCharacters, NumFrames);
+		std::printf("%-16s %8.2f ns/character/tick\n", Scenario.Name, NsPerTick);
+	}
+
+	// Substep cost per tick rate, and the mean downhill slide speed after one second. With a fixed step the speed only differs by the
+	// time still in the accumulator, unless a tick needs more than MaxSlideSubsteps steps and drops the rest (10 Hz at 120 Hz steps)
+	const float TickRates[] = { 10.f, 20.f, 30.f, 60.f, 144.f };
+	const float StepRates[] = { 0.f, 60.f, 120.f };
+
+	std::printf("\nSlide substepping, %d characters, one simulated second on a 20 degree ramp\n", NumCharacters);
+	for (float StepRate : StepRates)
+	{
+		for (float TickRate : TickRates)
+		{
+			const FSubstepResult Result = RunSubstepScenario(Settings, TickRate, StepRate, RampNormal, NumCharacters);
+			char StepName[32];
+			std::snprintf(StepName, sizeof(StepName), StepRate > 0.f ? "fixed %.0f Hz" : "per tick", StepRate);
+			std::printf("%-14s @ %3.0f Hz tick %8.2f ns/character/tick %10.1f ns/character/second  speed after 1s %8.2f\n",
+				StepName, TickRate, Result.NsPerTick, Result.NsPerSecond, Result.MeanSlideSpeed);
+		}
+	}
+
+	// Settings copied into every actor vs one shared tuning, the crowd sizes go from cache resident to far beyond it
+	const int LayoutCounts[] = { 1024, 16384, 131072 };
+
+	std::printf("\nCrowd layout, sliding on a 20 degree ramp, %d byte state, %d byte settings\n",
+		static_cast<int>(sizeof(FLocomotionState)), static_cast<int>(sizeof(FLocomotionSettings)));
+	for (int LayoutCount : LayoutCounts)
+	{
+		const int LayoutFrames = NumFrames * 1024 / LayoutCount > 10 ? NumFrames * 1024 / LayoutCount : 10;
+		const FLayoutResult PerInstance = RunLayoutScenario(false, RampNormal, LayoutCount, LayoutFrames);
+		const FLayoutResult Shared = RunLayoutScenario(true, RampNormal, LayoutCount, LayoutFrames);
+		std::printf("%6d characters: per-instance settings %6.2f ns/tick %5.2f lines/character, shared tuning %6.2f ns/tick %5.2f lines/character\n",
+			LayoutCount, PerInstance.NsPerTick, PerInstance.CacheLinesPerCharacter, Shared.NsPerTick, Shared.CacheLinesPerCharacter);
+	}
+
+	return 0;
+}
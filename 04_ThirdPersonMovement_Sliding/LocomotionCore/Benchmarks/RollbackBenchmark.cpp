@@ -0,0 +1,206 @@
+// Benchmark for locomotion rollback.
+// Records a scripted match into per-character rollback buffers, checks that resimulating buffered frames
+// with unchanged inputs lands on the live state bit for bit, then reports resimulated frames per millisecond
+// for 8 and 64 characters at several rollback depths.
+
+#include "LocomotionRollback.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const float DeltaTime = 1.f / 60.f;
+	const int LiveFrames = 600;
+
+	// Small deterministic generator so every run sees the same match
+	struct FRandomStream
+	{
+		uint32_t Seed;
+
+		float Next()
+		{
+			Seed = Seed * 1664525u + 1013904223u;
+			return static_cast<float>(Seed >> 8) / 16777216.f;
+		}
+	};
+
+	struct FCharacter
+	{
+		FLocomotionState State;
+		float CapsuleHalfHeight = 0.f;
+		FLocomotionRollbackBuffer Buffer;
+
+		FLocomotionVector Forward;
+		FLocomotionVector GroundNormal = FLocomotionVector::Up();
+		int Phase = 0;
+	};
+
+	// Sprint, slide, dance for a frame, jump with a double jump flip, crouch and go prone on a 4 second loop, out of phase per character
+	FLocomotionFrameInput MakeFrameInput(const FCharacter& Character, uint32_t Frame)
+	{
+		const int Step = static_cast<int>((Frame + Character.Phase) % 240);
+
+		FLocomotionFrameInput Input;
+		Input.Tick.DeltaTime = DeltaTime;
+		Input.Tick.Time = Frame * static_cast<double>(DeltaTime);
+		Input.Tick.ActorForward = Character.Forward;
+		Input.Tick.bIsGrounded = Step < 120 || Step >= 150;
+		Input.Tick.bIsFalling = !Input.Tick.bIsGrounded;
+		Input.Tick.bHasSlideGroundHit = Input.Tick.bIsGrounded;
+		Input.Tick.SlideGroundNormal = Character.GroundNormal;
+
+		// Move events only arrive while the stick is held
+		Input.bMoveInput = Step < 200;
+		Input.MovementInput.Y = 1.f;
+		Input.bRunHeld = Step < 180;
+		Input.bDancePressed = Step == 100;
+		Input.bCrouchPressed = Step == 20 || Step == 180;
+		Input.bCrouchReleased = Step == 80;
+		Input.bJumpPressed = Step == 115 || Step == 130;
+		Input.bPronePressed = Step == 190 || Step == 220;
+
+		Input.GroundSpeed = 600.f;
+		Input.GroundDistance = Input.Tick.bIsGrounded ? 0.f : 300.f;
+		Input.bCanStand = Step % 60 != 7;
+
+		if (Step == 121)
+		{
+			Input.Notifies |= FLocomotionFrameInput::NotifyApplyJumpForce;
+		}
+		if (Step == 133)
+		{
+			Input.Notifies |= FLocomotionFrameInput::NotifyTriggerFlip;
+		}
+		if (Step == 148)
+		{
+			Input.Notifies |= FLocomotionFrameInput::NotifyEndFlip;
+		}
+		if (Step == 192 || Step == 222)
+		{
+			Input.Notifies |= FLocomotionFrameInput::NotifyStartProneTransition;
+		}
+		if (Step == 205 || Step == 235)
+		{
+			Input.Notifies |= FLocomotionFrameInput::NotifyEndProneTransition;
+		}
+		return Input;
+	}
+
+	std::vector<FCharacter> MakeMatch(int NumCharacters, const FLocomotionSettings& Settings)
+	{
+		std::vector<FCharacter> Characters(NumCharacters);
+
+		FRandomStream Random{ 777u };
+		for (FCharacter& Character : Characters)
+		{
+			const float Yaw = Random.Next() * 2.f * LocomotionMath::Pi;
+			Character.Forward = FLocomotionVector(std::cos(Yaw), std::sin(Yaw), 0.f);
+
+			const float Slope = Random.Next() < 0.4f ? 0.f : Random.Next() * 30.f * LocomotionMath::Pi / 180.f;
+			const float Aspect = Random.Next() * 2.f * LocomotionMath::Pi;
+			Character.GroundNormal = FLocomotionVector(std::sin(Slope) * std::cos(Aspect), std::sin(Slope) * std::sin(Aspect), std::cos(Slope));
+
+			Character.Phase = static_cast<int>(Random.Next() * 240.f);
+			Character.CapsuleHalfHeight = Settings.StandCapsuleHalfHeight;
+		}
+		return Characters;
+	}
+
+	// Runs frames [0, NumFrames) live, recording every frame before it runs
+	void PlayLive(std::vector<FCharacter>& Characters, const FLocomotionSettings& Settings, uint32_t NumFrames)
+	{
+		FLocomotionTickOutput Output;
+		for (uint32_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (FCharacter& Character : Characters)
+			{
+				const FLocomotionFrameInput Input = MakeFrameInput(Character, Frame);
+				Character.Buffer.Record(Frame, LocomotionRollback::Capture(Character.State, Character.CapsuleHalfHeight), Input);
+				LocomotionRollback::SimulateFrame(Character.State, Character.CapsuleHalfHeight, Settings, Input, Output);
+			}
+		}
+	}
+
+	// Rolls every character back Depth frames from the end of the live run and compares the replayed state with the live one
+	int CountMismatches(std::vector<FCharacter> Characters, const FLocomotionSettings& Settings, uint32_t EndFrame, uint32_t Depth)
+	{
+		int Mismatches = 0;
+		for (FCharacter& Character : Characters)
+		{
+			const FLocomotionSnapshot Live = LocomotionRollback::Capture(Character.State, Character.CapsuleHalfHeight);
+
+			const int32_t NumFrames = Character.Buffer.Resimulate(EndFrame - Depth, EndFrame, Character.State, Character.CapsuleHalfHeight, Settings);
+			const FLocomotionSnapshot Replayed = LocomotionRollback::Capture(Character.State, Character.CapsuleHalfHeight);
+
+			const bool bSame = NumFrames == static_cast<int32_t>(Depth) && std::memcmp(&Live, &Replayed, sizeof(FLocomotionSnapshot)) == 0;
+			Mismatches += bSame ? 0 : 1;
+		}
+		return Mismatches;
+	}
+
+	volatile float GSink = 0.f;
+
+	// World frames (every character) resimulated per millisecond
+	double TimeResimulation(std::vector<FCharacter> Characters, const FLocomotionSettings& Settings, uint32_t EndFrame, uint32_t Depth, int Rollbacks)
+	{
+		int64_t FramesRun = 0;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Rollback = 0; Rollback < Rollbacks; ++Rollback)
+		{
+			for (FCharacter& Character : Characters)
+			{
+				FramesRun += Character.Buffer.Resimulate(EndFrame - Depth, EndFrame, Character.State, Character.CapsuleHalfHeight, Settings);
+			}
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		float Sum = 0.f;
+		for (const FCharacter& Character : Characters)
+		{
+			Sum += Character.State.SlideVelocity.X + Character.CapsuleHalfHeight;
+		}
+		GSink = Sum;
+
+		const double Milliseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count()) / 1e6;
+		const double WorldFrames = static_cast<double>(FramesRun) / Characters.size();
+		return WorldFrames / Milliseconds;
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	const int Rollbacks = Argc > 1 ? std::atoi(Argv[1]) : 2000;
+
+	FLocomotionSettings Settings;
+	Settings.SlideFixedStepRate = 60.f;
+
+	const int CharacterCounts[] = { 8, 64 };
+	const uint32_t Depths[] = { 8, 30, 60 };
+
+	std::printf("RollbackBenchmark: %d byte snapshot, %d frame buffer, %d rollbacks per row\n",
+		static_cast<int>(sizeof(FLocomotionSnapshot)), FLocomotionRollbackBuffer::Capacity, Rollbacks);
+
+	int TotalMismatches = 0;
+	for (int NumCharacters : CharacterCounts)
+	{
+		std::vector<FCharacter> Characters = MakeMatch(NumCharacters, Settings);
+		PlayLive(Characters, Settings, LiveFrames);
+
+		for (uint32_t Depth : Depths)
+		{
+			const int Mismatches = CountMismatches(Characters, Settings, LiveFrames, Depth);
+			TotalMismatches += Mismatches;
+
+			const double FramesPerMs = TimeResimulation(Characters, Settings, LiveFrames, Depth, Rollbacks);
+			std::printf("%3d characters, rollback %2u frames: %10.1f resimulated frames/ms %8.2f ns/character/frame  mismatches %d\n",
+				NumCharacters, Depth, FramesPerMs, 1e6 / (FramesPerMs * NumCharacters), Mismatches);
+		}
+	}
+
+	return TotalMismatches == 0 ? 0 : 1;
+}
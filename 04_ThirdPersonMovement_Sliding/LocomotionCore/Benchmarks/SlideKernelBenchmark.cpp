@@ -0,0 +1,240 @@
+// Benchmark for the batched slide kernel.
+// Verifies every SIMD path against the scalar path (and the scalar path against Locomotion::Tick)
+// bit for bit, then reports ns per character per step for crowd-sized batches.
+
+#include "SlideKernel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+	const float DeltaTime = 1.f / 30.f;
+
+	// Small deterministic generator so every run and every path sees the same crowd
+	struct FRandomStream
+	{
+		uint32_t Seed;
+
+		float Next()
+		{
+			Seed = Seed * 1664525u + 1013904223u;
+			return static_cast<float>(Seed >> 8) / 16777216.f;
+		}
+	};
+
+	struct FCrowd
+	{
+		std::vector<FLocomotionState> States;
+		std::vector<FLocomotionTickInput> Inputs;
+	};
+
+	FCrowd MakeCrowd(int NumCharacters, const FLocomotionSettings& Settings)
+	{
+		FCrowd Crowd;
+		Crowd.States.resize(NumCharacters);
+		Crowd.Inputs.resize(NumCharacters);
+
+		FRandomStream Random{ 12345u };
+		for (int Index = 0; Index < NumCharacters; ++Index)
+		{
+			const float Yaw = Random.Next() * 2.f * LocomotionMath::Pi;
+			const FLocomotionVector Forward(std::cos(Yaw), std::sin(Yaw), 0.f);
+
+			// Flat ground, gentle and steep ramps facing any direction
+			const float Slope = Random.Next() < 0.3f ? 0.f : Random.Next() * 40.f * LocomotionMath::Pi / 180.f;
+			const float Aspect = Random.Next() * 2.f * LocomotionMath::Pi;
+			const FLocomotionVector Normal(std::sin(Slope) * std::cos(Aspect), std::sin(Slope) * std::sin(Aspect), std::cos(Slope));
+
+			FLocomotionState& State = Crowd.States[Index];
+			State.bIsRunning = Random.Next() < 0.95f;
+			State.MovementInput.Y = 1.f;
+			Locomotion::StartSlide(State, Settings, Forward);
+			State.SlideVelocity *= 0.5f + Random.Next() * 3.f;
+
+			FLocomotionTickInput& Input = Crowd.Inputs[Index];
+			Input.DeltaTime = DeltaTime;
+			Input.bIsGrounded = Random.Next() < 0.9f;
+			Input.bIsFalling = !Input.bIsGrounded;
+			Input.ActorForward = Forward;
+			Input.bHasSlideGroundHit = Random.Next() < 0.95f;
+			Input.SlideGroundNormal = Normal;
+		}
+		return Crowd;
+	}
+
+	FSlideBatch MakeBatch(const FCrowd& Crowd)
+	{
+		FSlideBatch Batch;
+		Batch.Resize(static_cast<int32_t>(Crowd.States.size()));
+		for (int32_t Index = 0; Index < Batch.Num(); ++Index)
+		{
+			Batch.LoadLane(Index, Crowd.States[Index], Crowd.Inputs[Index]);
+		}
+		return Batch;
+	}
+
+	bool SameBits(float A, float B)
+	{
+		return std::memcmp(&A, &B, sizeof(float)) == 0;
+	}
+
+	int CountMismatches(const FSlideBatch& A, const FSlideBatch& B)
+	{
+		int Mismatches = 0;
+		for (int32_t Index = 0; Index < A.Num(); ++Index)
+		{
+			const bool bSame =
+				SameBits(A.VelocityX[Index], B.VelocityX[Index]) && SameBits(A.VelocityY[Index], B.VelocityY[Index]) && SameBits(A.VelocityZ[Index], B.VelocityZ[Index]) &&
+				SameBits(A.FallTimer[Index], B.FallTimer[Index]) && SameBits(A.StartTimer[Index], B.StartTimer[Index]) &&
+				SameBits(A.MoveDirectionX[Index], B.MoveDirectionX[Index]) && SameBits(A.MoveDirectionY[Index], B.MoveDirectionY[Index]) && SameBits(A.MoveDirectionZ[Index], B.MoveDirectionZ[Index]) &&
+				SameBits(A.MoveScale[Index], B.MoveScale[Index]) && A.ExitSlide[Index] == B.ExitSlide[Index];
+			Mismatches += bSame ? 0 : 1;
+		}
+		return Mismatches;
+	}
+
+	// Steps the batch and the per-character Tick side by side and compares the slide results
+	int CountTickMismatches(FCrowd Crowd, const FLocomotionSettings& Settings, int NumFrames, float TickDeltaTime)
+	{
+		for (FLocomotionTickInput& Input : Crowd.Inputs)
+		{
+			Input.DeltaTime = TickDeltaTime;
+		}
+
+		FSlideBatch Batch = MakeBatch(Crowd);
+		int Mismatches = 0;
+
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			SlideKernel::Step(Batch, Settings, TickDeltaTime, ESlideKernelPath::Scalar);
+
+			for (int32_t Index = 0; Index < Batch.Num(); ++Index)
+			{
+				FLocomotionTickOutput Output;
+				Locomotion::Tick(Crowd.States[Index], Settings, Crowd.Inputs[Index], Output);
+
+				const FLocomotionVector& Velocity = Crowd.States[Index].SlideVelocity;
+				const bool bSame =
+					SameBits(Velocity.X, Batch.VelocityX[Index]) && SameBits(Velocity.Y, Batch.VelocityY[Index]) && SameBits(Velocity.Z, Batch.VelocityZ[Index]) &&
+					SameBits(Output.SlideMoveScale, Batch.MoveScale[Index]) && Output.bExitSlide == (Batch.ExitSlide[Index] != 0);
+				Mismatches += bSame ? 0 : 1;
+
+				// Keep both sides sliding so later frames keep comparing the slide path
+				Crowd.States[Index].Stance = ELocomotionStance::Sliding;
+			}
+		}
+		return Mismatches;
+	}
+
+	double TimePath(const FSlideBatch& Source, const FLocomotionSettings& Settings, ESlideKernelPath Path, int NumFrames)
+	{
+		FSlideBatch Batch = Source;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			SlideKernel::Step(Batch, Settings, DeltaTime, Path);
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		const double Nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count());
+		return Nanoseconds / (static_cast<double>(Batch.Num()) * NumFrames);
+	}
+
+	double TimeTick(FCrowd Crowd, const FLocomotionSettings& Settings, int NumFrames)
+	{
+		FLocomotionTickOutput Output;
+
+		const auto Start = std::chrono::steady_clock::now();
+		for (int Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			for (size_t Index = 0; Index < Crowd.States.size(); ++Index)
+			{
+				Locomotion::Tick(Crowd.States[Index], Settings, Crowd.Inputs[Index], Output);
+				Crowd.States[Index].Stance = ELocomotionStance::Sliding;
+			}
+		}
+		const auto End = std::chrono::steady_clock::now();
+
+		const double Nanoseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start).count());
+		return Nanoseconds / (static_cast<double>(Crowd.States.size()) * NumFrames);
+	}
+}
+
+int main(int Argc, char** Argv)
+{
+	const int NumFrames = Argc > 1 ? std::atoi(Argv[1]) : 300;
+
+	const FLocomotionSettings Settings;
+	const ESlideKernelPath Paths[] = { ESlideKernelPath::Scalar, ESlideKernelPath::SSE41, ESlideKernelPath::AVX2 };
+
+	// Validation, odd size so the vector paths also exercise their scalar tail
+	const int ValidationNum = 1027;
+	const int ValidationFrames = 90;
+	const FCrowd ValidationCrowd = MakeCrowd(ValidationNum, Settings);
+	int TotalMismatches = 0;
+
+	const int TickMismatches = CountTickMismatches(ValidationCrowd, Settings, ValidationFrames, DeltaTime);
+	std::printf("Validation Scalar vs Locomotion::Tick: %d mismatching lane-steps\n", TickMismatches);
+	TotalMismatches += TickMismatches;
+
+	// 10 Hz tick LOD and a 250 ms hitch, split into MaxSlideStepTime steps on both sides
+	const float LongDeltaTimes[] = { 0.1f, 0.25f };
+	for (float LongDeltaTime : LongDeltaTimes)
+	{
+		const int LongMismatches = CountTickMismatches(ValidationCrowd, Settings, ValidationFrames, LongDeltaTime);
+		std::printf("Validation Scalar vs Locomotion::Tick at %.0f ms: %d mismatching lane-steps\n", LongDeltaTime * 1000.f, LongMismatches);
+		TotalMismatches += LongMismatches;
+	}
+
+	for (ESlideKernelPath Path : Paths)
+	{
+		if (Path == ESlideKernelPath::Scalar || !SlideKernel::IsPathSupported(Path))
+		{
+			continue;
+		}
+
+		FSlideBatch Reference = MakeBatch(ValidationCrowd);
+		FSlideBatch Candidate = Reference;
+		int Mismatches = 0;
+		for (int Frame = 0; Frame < ValidationFrames; ++Frame)
+		{
+			// Every tenth frame is a hitch, so the split steps and exited lane masking run on the vector path too
+			const float FrameDeltaTime = Frame % 10 == 9 ? 0.25f : DeltaTime;
+			SlideKernel::Step(Reference, Settings, FrameDeltaTime, ESlideKernelPath::Scalar);
+			SlideKernel::Step(Candidate, Settings, FrameDeltaTime, Path);
+			Mismatches += CountMismatches(Reference, Candidate);
+		}
+		std::printf("Validation %s vs Scalar: %d mismatching lane-steps\n", SlideKernel::GetPathName(Path), Mismatches);
+		TotalMismatches += Mismatches;
+	}
+
+	// Timing at server crowd sizes
+	const int CrowdSizes[] = { 1000, 2000, 5000 };
+	for (int NumCharacters : CrowdSizes)
+	{
+		const FCrowd Crowd = MakeCrowd(NumCharacters, Settings);
+		const FSlideBatch Batch = MakeBatch(Crowd);
+
+		const double TickNs = TimeTick(Crowd, Settings, NumFrames);
+		std::printf("\n%d sliding characters, %d frames\n", NumCharacters, NumFrames);
+		std::printf("  %-18s %8.2f ns/character/step\n", "Locomotion::Tick", TickNs);
+
+		for (ESlideKernelPath Path : Paths)
+		{
+			if (!SlideKernel::IsPathSupported(Path))
+			{
+				std::printf("  %-18s unsupported\n", SlideKernel::GetPathName(Path));
+				continue;
+			}
+			const double PathNs = TimePath(Batch, Settings, Path, NumFrames);
+			std::printf("  %-18s %8.2f ns/character/step (%.2fx vs Tick)\n", SlideKernel::GetPathName(Path), PathNs, TickNs / PathNs);
+		}
+	}
+
+	return TotalMismatches == 0 ? 0 : 1;
+}
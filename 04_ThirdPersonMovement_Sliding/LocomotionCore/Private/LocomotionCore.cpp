@@ -0,0 +1,672 @@
+#include "LocomotionCore.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Speed and acceleration below which a character counts as standing still, in units/s and units/s²
+	constexpr float IdleMotionTolerance = 1.f;
+
+	// One slide integration step of StepTime seconds. Returns false when the slide should end
+	bool StepSlide(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, float StepTime, FLocomotionTickOutput& Output, float& OutSlideSpeed)
+	{
+		FLocomotionVector& SlideVelocity = State.SlideVelocity;
+
+		bool bIsDownhillAligned = false;
+		float SlideExitSpeedThreshold = Settings.MinSlideSpeed;
+		float Alignment = 0.f;
+
+		if (Input.bHasSlideGroundHit)
+		{
+			const FLocomotionVector GroundNormal = Input.SlideGroundNormal;
+
+			const float Incline = FLocomotionVector::DotProduct(GroundNormal, FLocomotionVector::Up());
+			const float SlopeAngle = LocomotionMath::RadiansToDegrees(LocomotionMath::Acos(Incline));
+
+			const FLocomotionVector DownhillDir = FLocomotionVector::CrossProduct(GroundNormal, FLocomotionVector::CrossProduct(FLocomotionVector::Up(), GroundNormal)).GetSafeNormal();
+			Alignment = FLocomotionVector::DotProduct(SlideVelocity.GetSafeNormal(), DownhillDir);
+
+			Output.bHasSlideSlope = true;
+			Output.SlideSlopeAngle = SlopeAngle;
+			Output.SlideAlignment = Alignment;
+
+			// Downhill boost
+			if (SlopeAngle > 10.f && Alignment < 0.5f)
+			{
+				const float BoostScale = LocomotionMath::Clamp((1.f - Alignment) * (SlopeAngle / 30.f), 0.5f, 2.5f);
+				SlideVelocity += DownhillDir * (Settings.RampBoostSpeed * StepTime * BoostScale);
+				bIsDownhillAligned = true;
+				Output.bRampBoostApplied = true;
+			}
+
+			// Uphill penalty
+			if (Alignment > 0.f)
+			{
+				const float UphillPenalty = LocomotionMath::Clamp(Alignment, 0.2f, 1.f);
+				const float PenaltyScale = 1.f - UphillPenalty * 0.5f;
+				const float PenaltyExponent = Settings.UphillPenaltyReferenceRate > 0.f ? StepTime * Settings.UphillPenaltyReferenceRate : 1.f;
+				SlideVelocity *= PenaltyExponent == 1.f ? PenaltyScale : std::pow(PenaltyScale, PenaltyExponent);
+				Output.bUphillPenaltyApplied = true;
+			}
+
+			// Adjust exit threshold for downhill
+			SlideExitSpeedThreshold = bIsDownhillAligned ? Settings.MinSlideSpeed * 0.5f : Settings.MinSlideSpeed;
+
+			// Flat boost scaled and interpolated
+			const float FlatBoostScale = LocomotionMath::Clamp(1.f - Alignment, 0.f, 1.f);
+			const FLocomotionVector TargetFlatBoost = Input.ActorForward * (Settings.FlatSlideBoost * FlatBoostScale);
+			SlideVelocity = LocomotionMath::VInterpTo(SlideVelocity, TargetFlatBoost, StepTime, 3.0f);
+		}
+
+		// Clamp max slide speed
+		SlideVelocity = SlideVelocity.GetClampedToMaxSize(Settings.MaxSlideSpeed);
+		Output.bSetMaxWalkSpeed = true;
+		Output.MaxWalkSpeed = Settings.MaxSlideSpeed;
+
+		// Apply movement
+		OutSlideSpeed = SlideVelocity.Size();
+		Output.bApplySlideMovement = true;
+		Output.SlideMoveDirection = SlideVelocity.GetSafeNormal();
+
+		// Track airborne slide time
+		if (!Input.bIsGrounded)
+		{
+			State.SlideFallTimer += StepTime;
+		}
+		else
+		{
+			State.SlideFallTimer = 0.f;
+		}
+
+		// Grace period timer
+		if (State.SlideStartTimer > 0.f)
+		{
+			State.SlideStartTimer -= StepTime;
+		}
+
+		// Exit slide conditions
+		const bool bShouldExitSlide = OutSlideSpeed < SlideExitSpeedThreshold && !bIsDownhillAligned;
+
+		if (State.SlideStartTimer <= 0.f && (bShouldExitSlide || State.SlideFallTimer > Settings.SlideFallGraceTime || !State.bIsRunning))
+		{
+			return false;
+		}
+
+		SlideVelocity = LocomotionMath::VInterpTo(SlideVelocity, FLocomotionVector::Zero(), StepTime, Settings.SlideFriction);
+		return true;
+	}
+
+	// Runs the slide at Settings.SlideFixedStepRate, carrying the remainder to the next tick
+	bool StepSlideFixed(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, FLocomotionTickOutput& Output, float& OutSlideSpeed)
+	{
+		const float Step = 1.f / Settings.SlideFixedStepRate;
+
+		// Frames shorter than a step still move with the last integrated velocity
+		OutSlideSpeed = State.SlideVelocity.Size();
+		Output.bSetMaxWalkSpeed = true;
+		Output.MaxWalkSpeed = Settings.MaxSlideSpeed;
+		Output.bApplySlideMovement = true;
+		Output.SlideMoveDirection = State.SlideVelocity.GetSafeNormal();
+
+		State.SlideStepAccumulator += Input.DeltaTime;
+
+		int32_t Substeps = 0;
+		while (State.SlideStepAccumulator >= Step && Substeps < Settings.MaxSlideSubsteps)
+		{
+			State.SlideStepAccumulator -= Step;
+			++Substeps;
+
+			if (!StepSlide(State, Settings, Input, Step, Output, OutSlideSpeed))
+			{
+				return false;
+			}
+		}
+
+		// Past the cap the slide loses the time instead of bursting forward on later frames
+		if (State.SlideStepAccumulator >= Step)
+		{
+			State.SlideStepAccumulator = std::fmod(State.SlideStepAccumulator, Step);
+		}
+		return true;
+	}
+
+	bool StepSlideVariable(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, FLocomotionTickOutput& Output, float& OutSlideSpeed)
+	{
+		// Short ticks take one step with the raw delta time, long ones keep the interp and boost steps small
+		int32_t Steps = 1;
+		if (Settings.MaxSlideStepTime > 0.f && Input.DeltaTime > Settings.MaxSlideStepTime)
+		{
+			Steps = std::min(static_cast<int32_t>(std::ceil(Input.DeltaTime / Settings.MaxSlideStepTime)), std::max(Settings.MaxSlideSubsteps, 1));
+		}
+
+		const float Step = Input.DeltaTime / static_cast<float>(Steps);
+		for (int32_t Index = 0; Index < Steps; ++Index)
+		{
+			if (!StepSlide(State, Settings, Input, Step, Output, OutSlideSpeed))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void BeginSlide(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionVector& ActorForward)
+	{
+		State.SlideStartTimer = Settings.SlideStartGraceTime;
+		State.SlideFallTimer = 0.f;
+		State.SlideStepAccumulator = 0.f;
+		State.SlideVelocity = ActorForward * Settings.SlideSpeed;
+	}
+
+	// Slide timers while the movement mode is airborne, the velocity is left to the falling physics
+	bool StepAirborneSlide(FLocomotionState& State, const FLocomotionSettings& Settings, float DeltaTime)
+	{
+		State.SlideFallTimer += DeltaTime;
+
+		if (State.SlideStartTimer > 0.f)
+		{
+			State.SlideStartTimer -= DeltaTime;
+		}
+
+		return State.SlideStartTimer > 0.f || (State.SlideFallTimer <= Settings.SlideFallGraceTime && State.bIsRunning);
+	}
+}
+
+namespace Locomotion
+{
+	void Tick(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, FLocomotionTickOutput& Output)
+	{
+		Output = FLocomotionTickOutput();
+
+		const float DeltaTime = Input.DeltaTime;
+		const bool bIsGrounded = Input.bIsGrounded;
+		const bool bIsFalling = Input.bIsFalling;
+
+		// Crouched stances only react to falling (prone drops back to crouch)
+		if (!LocomotionStance::GetInfo(State.Stance).bRunsJumpRules)
+		{
+			if (bIsFalling)
+			{
+				ApplyStanceEvent(State, ELocomotionStanceEvent::Fall);
+			}
+			return;
+		}
+
+		// Sliding logic
+		if (State.IsSliding())
+		{
+			bool bKeepSliding = true;
+			if (Settings.bSlideInMovementMode)
+			{
+				// Grounded slides are integrated by the movement mode itself
+				bKeepSliding = bIsGrounded || StepAirborneSlide(State, Settings, DeltaTime);
+			}
+			else
+			{
+				float SlideSpeed = 0.f;
+				bKeepSliding = StepSlideMovement(State, Settings, Input, Output, SlideSpeed);
+				Output.SlideMoveScale = SlideSpeed * DeltaTime;
+			}
+
+			if (!bKeepSliding)
+			{
+				Output.bExitSlide = true;
+				return;
+			}
+		}
+
+		// Jump buffer
+		if (State.bJumpInputQueued && Input.Time >= State.JumpBufferDeadline)
+		{
+			State.bJumpInputQueued = false;
+		}
+
+		// Grounded jump reset
+		if (bIsGrounded)
+		{
+			State.JumpCount = 0;
+			State.bJumpPending = false;
+			State.JumpPhase = LocomotionStance::SetFlag(State.JumpPhase, ELocomotionJumpPhase::Flipping, false);
+		}
+
+		// Buffered jump
+		if (bIsGrounded && State.bJumpInputQueued && !State.bJumpPending)
+		{
+			State.bJumpPending = true;
+			State.bJumpInputQueued = false;
+			State.JumpCount++;
+			State.JumpPhase = LocomotionStance::SetFlag(State.JumpPhase, ELocomotionJumpPhase::Jumping, true);
+		}
+
+		// Double jump
+		if (!bIsGrounded && Settings.bAllowDoubleJump && State.JumpCount < 2 && State.bJumpInputQueued && !State.bJumpPending)
+		{
+			State.JumpPhase = ELocomotionJumpPhase::JumpingAndFlipping;
+			State.bJumpPending = true;
+			State.bJumpInputQueued = false;
+			State.JumpCount++;
+		}
+
+		// Reset jump flag when falling
+		if (State.IsJumping() && bIsFalling)
+		{
+			State.JumpPhase = LocomotionStance::SetFlag(State.JumpPhase, ELocomotionJumpPhase::Jumping, false);
+		}
+	}
+
+	bool ApplyStanceEvent(FLocomotionState& State, ELocomotionStanceEvent Event)
+	{
+		const ELocomotionStance NextStance = LocomotionStance::Next(State.Stance, Event);
+		if (NextStance == LocomotionStance::Invalid)
+		{
+			return false;
+		}
+		State.Stance = NextStance;
+		return true;
+	}
+
+	FLocomotionStanceChange MakeStanceChange(const FLocomotionSettings& Settings, ELocomotionStance Stance)
+	{
+		const FLocomotionStanceInfo& Info = LocomotionStance::GetInfo(Stance);
+
+		FLocomotionStanceChange Change;
+		Change.bApply = true;
+		Change.CapsuleHalfHeight = Settings.*Info.CapsuleHalfHeight;
+		Change.MeshOffsetZ = -Change.CapsuleHalfHeight;
+		Change.bSetMaxWalkSpeed = !Info.bOwnsMaxSpeed;
+		Change.MaxWalkSpeed = Settings.*Info.MaxSpeed;
+		return Change;
+	}
+
+	bool IsIdle(const FLocomotionState& State, const FLocomotionTickInput& Input)
+	{
+		// Slides integrate every frame, and falling drives the jump phase and the crouched Fall event
+		if (State.IsSliding() || Input.bIsFalling)
+		{
+			return false;
+		}
+
+		// Walking still changes the movement state, and a held key the next frame's input
+		const float ToleranceSquared = IdleMotionTolerance * IdleMotionTolerance;
+		if (Input.Velocity.SizeSquared() > ToleranceSquared || Input.Acceleration.SizeSquared() > ToleranceSquared)
+		{
+			return false;
+		}
+
+		// Crouched stances only react to falling
+		if (!LocomotionStance::GetInfo(State.Stance).bRunsJumpRules)
+		{
+			return true;
+		}
+
+		// A queued jump waits on its deadline, and the grounded reset has to have cleared the jump
+		return Input.bIsGrounded && !State.bJumpInputQueued && !State.bJumpPending && State.JumpCount == 0 && State.JumpPhase == ELocomotionJumpPhase::None;
+	}
+
+	bool NeedsSlideGroundProbe(const FLocomotionState& State, const FLocomotionSettings& Settings)
+	{
+		// The slide movement mode reads its own floor
+		return State.IsSliding() && !Settings.bSlideInMovementMode;
+	}
+
+	bool StepSlideMovement(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, FLocomotionTickOutput& Output, float& OutSlideSpeed)
+	{
+		return Settings.SlideFixedStepRate > 0.f ?
+			StepSlideFixed(State, Settings, Input, Output, OutSlideSpeed) :
+			StepSlideVariable(State, Settings, Input, Output, OutSlideSpeed);
+	}
+
+	bool AcceptMoveInput(FLocomotionState& State, float InputX, float InputY, bool bHasController)
+	{
+		State.MovementInput.X = InputX;
+		State.MovementInput.Y = InputY;
+
+		if (!bHasController || LocomotionStance::GetInfo(State.Stance).bBlocksMoveInput)
+		{
+			return false;
+		}
+
+		if (State.IsDancing())
+		{
+			const bool bHasInput = std::abs(InputX) > LocomotionMath::KindaSmallNumber || std::abs(InputY) > LocomotionMath::KindaSmallNumber;
+			if (!bHasInput)
+			{
+				return false;
+			}
+			ApplyStanceEvent(State, ELocomotionStanceEvent::StopDance);
+		}
+
+		return true;
+	}
+
+	bool ResolveMaxWalkSpeed(const FLocomotionState& State, const FLocomotionSettings& Settings, float ForwardInput, float& OutMaxWalkSpeed)
+	{
+		const FLocomotionStanceInfo& Info = LocomotionStance::GetInfo(State.Stance);
+		if (Info.bOwnsMaxSpeed)
+		{
+			return false;
+		}
+
+		const bool bSprinting = Info.bCanSprint && State.bIsRunning && ForwardInput >= 0.f;
+		OutMaxWalkSpeed = bSprinting ? Settings.SprintSpeed : Settings.*Info.MaxSpeed;
+		return true;
+	}
+
+	bool SetRunning(FLocomotionState& State, const FLocomotionSettings& Settings, bool bRunning, float& OutMaxWalkSpeed)
+	{
+		State.bIsRunning = bRunning;
+
+		if (bRunning)
+		{
+			if (State.MovementInput.Y >= 0.f)
+			{
+				OutMaxWalkSpeed = Settings.SprintSpeed;
+				return true;
+			}
+			return false;
+		}
+
+		OutMaxWalkSpeed = Settings.WalkSpeed;
+		return true;
+	}
+
+	FLocomotionEventResult HandleEvent(FLocomotionState& State, const FLocomotionSettings& Settings, ELocomotionEvent Event, const FLocomotionEventContext& Context)
+	{
+		FLocomotionEventResult Result;
+		switch (Event)
+		{
+		case ELocomotionEvent::Move:
+			Result.bAcceptedMove = AcceptMoveInput(State, Context.MoveInput.X, Context.MoveInput.Y, Context.bHasController);
+			if (Result.bAcceptedMove)
+			{
+				Result.bSetMaxWalkSpeed = ResolveMaxWalkSpeed(State, Settings, Context.MoveInput.Y, Result.MaxWalkSpeed);
+			}
+			break;
+
+		case ELocomotionEvent::RunPressed:
+		case ELocomotionEvent::RunReleased:
+			Result.bSetMaxWalkSpeed = SetRunning(State, Settings, Event == ELocomotionEvent::RunPressed, Result.MaxWalkSpeed);
+			break;
+
+		case ELocomotionEvent::Dance:
+			StartDance(State);
+			break;
+
+		case ELocomotionEvent::Jump:
+			QueueJumpInput(State, Settings, Context.Time);
+			break;
+
+		case ELocomotionEvent::CrouchPressed:
+			if (!CanHandleCrouchOrSlidePress(State))
+			{
+				break;
+			}
+			if (WantsSlideFromCrouchPress(State, Settings, Context.bIsGrounded, Context.GroundDistance))
+			{
+				if (CanStartSlide(State, Settings, Context.GroundSpeed, Context.bIsGrounded, Context.GroundDistance))
+				{
+					Result.StanceChange = StartSlide(State, Settings, Context.ActorForward);
+				}
+			}
+			else if (Context.bIsGrounded)
+			{
+				// Standing up needs clearance
+				Result.StanceChange = ToggleCrouch(State, Settings, !State.IsCrouching() || Context.bCanStand);
+			}
+			break;
+
+		case ELocomotionEvent::CrouchReleased:
+			if (State.IsSliding())
+			{
+				Result.StanceChange = ExitSlide(State, Settings, Context.bCanStand, Context.bCanCrouch);
+			}
+			break;
+
+		case ELocomotionEvent::Prone:
+			if (CanToggleProne(State, Context.bIsFalling))
+			{
+				Result.StanceChange = ToggleProne(State, Settings, Context.CapsuleHalfHeight, State.IsProning() && Context.bCanCrouch);
+			}
+			break;
+
+		case ELocomotionEvent::ApplyJumpForce: ApplyJumpForce(State); break;
+		case ELocomotionEvent::TriggerFlip: TriggerFlip(State); break;
+		case ELocomotionEvent::EndFlip: EndFlip(State); break;
+		case ELocomotionEvent::StartProneTransition: StartProneTransition(State); break;
+		case ELocomotionEvent::EndProneTransition: EndProneTransition(State); break;
+		}
+		return Result;
+	}
+
+	uint8_t GetEventQueries(const FLocomotionState& State, ELocomotionEvent Event)
+	{
+		switch (Event)
+		{
+		case ELocomotionEvent::CrouchPressed:
+			if (!CanHandleCrouchOrSlidePress(State))
+			{
+				return 0;
+			}
+			return FLocomotionEventContext::QueryGround | (State.IsCrouching() ? FLocomotionEventContext::QueryClearance : 0);
+		case ELocomotionEvent::CrouchReleased:
+			return State.IsSliding() ? FLocomotionEventContext::QueryClearance : 0;
+		case ELocomotionEvent::Prone:
+			return State.IsProning() ? FLocomotionEventContext::QueryClearance : 0;
+		default:
+			return 0;
+		}
+	}
+
+	void StartDance(FLocomotionState& State)
+	{
+		ApplyStanceEvent(State, ELocomotionStanceEvent::StartDance);
+	}
+
+	void QueueJumpInput(FLocomotionState& State, const FLocomotionSettings& Settings, double Time)
+	{
+		if (!LocomotionStance::GetInfo(State.Stance).bCanQueueJump)
+		{
+			return;
+		}
+		State.bJumpInputQueued = true;
+		State.JumpBufferDeadline = Time + Settings.JumpBufferTime;
+	}
+
+	void ApplyJumpForce(FLocomotionState& State)
+	{
+		State.bJumpPending = false;
+	}
+
+	void TriggerFlip(FLocomotionState& State)
+	{
+		State.JumpPhase = ELocomotionJumpPhase::JumpingAndFlipping;
+		State.bJumpPending = true;
+		State.JumpCount++;
+	}
+
+	void EndFlip(FLocomotionState& State)
+	{
+		State.JumpPhase = ELocomotionJumpPhase::None;
+	}
+
+	void StartProneTransition(FLocomotionState& State)
+	{
+		ApplyStanceEvent(State, ELocomotionStanceEvent::BeginProneTransition);
+	}
+
+	void EndProneTransition(FLocomotionState& State)
+	{
+		ApplyStanceEvent(State, ELocomotionStanceEvent::EndProneTransition);
+	}
+
+	bool CanHandleCrouchOrSlidePress(const FLocomotionState& State)
+	{
+		return !(State.IsProning() || State.IsJumping() || State.IsFlipping() || State.IsInProneTransition());
+	}
+
+	bool WantsSlideFromCrouchPress(const FLocomotionState& State, const FLocomotionSettings& Settings, bool bIsGrounded, float GroundDistance)
+	{
+		const bool bNearGround = GroundDistance <= Settings.SlideAirThreshold;
+		const bool bCanSlide = !State.IsSliding() && State.bIsRunning && State.MovementInput.Size() > 0.1f;
+		return bCanSlide && (bIsGrounded || bNearGround);
+	}
+
+	bool CanStartSlide(const FLocomotionState& State, const FLocomotionSettings& Settings, float CurrentSpeed, bool bIsGrounded, float GroundDistance)
+	{
+		// Check if already sliding or in a conflicting state
+		const bool bStanceAllowsSlide = LocomotionStance::Next(State.Stance, ELocomotionStanceEvent::StartSlide) != LocomotionStance::Invalid;
+		if (!bStanceAllowsSlide || !State.bIsRunning || State.MovementInput.Size() < 0.1f || State.MovementInput.Y < 0.f || CurrentSpeed <= 0.f)
+		{
+			return false;
+		}
+
+		// Grounded OR close enough to the ground to allow mid-air slide
+		return bIsGrounded || GroundDistance <= Settings.SlideAirThreshold;
+	}
+
+	FLocomotionStanceChange StartSlide(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionVector& ActorForward)
+	{
+		if (!ApplyStanceEvent(State, ELocomotionStanceEvent::StartSlide))
+		{
+			return FLocomotionStanceChange();
+		}
+
+		BeginSlide(State, Settings, ActorForward);
+
+		// Speed is taken over by the slide tick
+		FLocomotionStanceChange Change = MakeStanceChange(Settings, State.Stance);
+		Change.bSetMaxWalkSpeed = false;
+		return Change;
+	}
+
+	FLocomotionStanceChange ForceStance(FLocomotionState& State, const FLocomotionSettings& Settings, ELocomotionStance Stance, const FLocomotionVector& ActorForward, bool bCanStand, bool bCanCrouch)
+	{
+		if (LocomotionStance::GetInfo(State.Stance).Parent == LocomotionStance::GetInfo(Stance).Parent || !LocomotionStance::CanReach(State.Stance, Stance))
+		{
+			return FLocomotionStanceChange();
+		}
+
+		// Growing the capsule needs the same clearance the local toggles check
+		const float CurrentHalfHeight = Settings.*LocomotionStance::GetInfo(State.Stance).CapsuleHalfHeight;
+		const float TargetHalfHeight = Settings.*LocomotionStance::GetInfo(Stance).CapsuleHalfHeight;
+		if (TargetHalfHeight > CurrentHalfHeight && !(TargetHalfHeight > Settings.CrouchCapsuleHalfHeight ? bCanStand : bCanCrouch))
+		{
+			return FLocomotionStanceChange();
+		}
+
+		return AdoptStance(State, Settings, Stance, ActorForward);
+	}
+
+	FLocomotionStanceChange AdoptStance(FLocomotionState& State, const FLocomotionSettings& Settings, ELocomotionStance Stance, const FLocomotionVector& ActorForward)
+	{
+		if (LocomotionStance::GetInfo(State.Stance).Parent == LocomotionStance::GetInfo(Stance).Parent)
+		{
+			return FLocomotionStanceChange();
+		}
+
+		State.Stance = Stance;
+		if (State.IsSliding())
+		{
+			BeginSlide(State, Settings, ActorForward);
+		}
+		return MakeStanceChange(Settings, State.Stance);
+	}
+
+	FLocomotionStanceChange ExitSlide(FLocomotionState& State, const FLocomotionSettings& Settings, bool bCanStand, bool bCanCrouch)
+	{
+		const ELocomotionStanceEvent Event =
+			bCanStand && bCanCrouch ? ELocomotionStanceEvent::ExitSlideToStand :
+			bCanCrouch ? ELocomotionStanceEvent::ExitSlideToCrouch :
+			ELocomotionStanceEvent::ExitSlideToProne;
+
+		if (!ApplyStanceEvent(State, Event))
+		{
+			return FLocomotionStanceChange();
+		}
+		return MakeStanceChange(Settings, State.Stance);
+	}
+
+	FLocomotionStanceChange ToggleCrouch(FLocomotionState& State, const FLocomotionSettings& Settings, bool bCanStand)
+	{
+		const ELocomotionStanceEvent Event = State.IsCrouching() ? ELocomotionStanceEvent::Stand : ELocomotionStanceEvent::Crouch;
+		if ((Event == ELocomotionStanceEvent::Stand && !bCanStand) || !ApplyStanceEvent(State, Event))
+		{
+			return FLocomotionStanceChange();
+		}
+		return MakeStanceChange(Settings, State.Stance);
+	}
+
+	bool CanToggleProne(const FLocomotionState& State, bool bIsFalling)
+	{
+		return !(State.IsInProneTransition() || State.bIsRunning || State.IsJumping() || State.IsFlipping() || bIsFalling);
+	}
+
+	FLocomotionStanceChange ToggleProne(FLocomotionState& State, const FLocomotionSettings& Settings, float CurrentCapsuleHalfHeight, bool bCanCrouchUp)
+	{
+		FLocomotionStanceChange Change;
+
+		if (State.IsProning())
+		{
+			if (bCanCrouchUp && ApplyStanceEvent(State, ELocomotionStanceEvent::CrouchFromProne))
+			{
+				Change = MakeStanceChange(Settings, State.Stance);
+				const float Delta = Change.CapsuleHalfHeight - CurrentCapsuleHalfHeight;
+
+				Change.PreOffsetZ = 2.0f;
+				Change.OffsetZ = -Delta * 0.95f + Settings.CustomCapsuleCrouchOffset;
+			}
+		}
+		else if (ApplyStanceEvent(State, ELocomotionStanceEvent::Prone))
+		{
+			Change = MakeStanceChange(Settings, State.Stance);
+			const float Delta = CurrentCapsuleHalfHeight - Change.CapsuleHalfHeight;
+
+			Change.OffsetZ = Delta * 0.95f + Settings.CustomCapsuleProneOffset;
+		}
+		return Change;
+	}
+
+	FLocomotionClearanceSweep MakeClearanceSweep(const FLocomotionSettings& Settings, float CurrentHalfHeight, float Radius)
+	{
+		FLocomotionClearanceSweep Sweep;
+		Sweep.StartHeight = std::max(CurrentHalfHeight - Radius, 0.f);
+		Sweep.EndHeight = std::max(Settings.StandCapsuleHalfHeight - Radius, Sweep.StartHeight);
+		Sweep.Radius = Radius;
+		return Sweep;
+	}
+
+	FLocomotionClearance ResolveClearance(const FLocomotionSettings& Settings, const FLocomotionClearanceSweep& Sweep, float CeilingCheckOffset,
+		bool bHit, bool bStartPenetrating, float HitDistance)
+	{
+		FLocomotionClearance Clearance;
+		if (!bStartPenetrating)
+		{
+			Clearance.Headroom = (bHit ? Sweep.StartHeight + HitDistance : Sweep.EndHeight) + Sweep.Radius;
+		}
+
+		Clearance.Clearance =
+			Clearance.Headroom >= Settings.StandCapsuleHalfHeight - CeilingCheckOffset ? ELocomotionClearance::Stand :
+			Clearance.Headroom >= Settings.CrouchCapsuleHalfHeight ? ELocomotionClearance::Crouch :
+			ELocomotionClearance::ProneOnly;
+		return Clearance;
+	}
+
+	float ResolveStanceOffsetZ(const FLocomotionStanceChange& Change, float FloorGap, float CeilingGap)
+	{
+		float Offset = 0.f;
+		for (const float Step : { Change.PreOffsetZ, Change.OffsetZ })
+		{
+			Offset += Step;
+			if (CeilingGap >= 0.f)
+			{
+				Offset = std::min(Offset, CeilingGap);
+			}
+			if (FloorGap >= 0.f)
+			{
+				Offset = std::max(Offset, -FloorGap);
+			}
+		}
+		return Offset;
+	}
+}
@@ -0,0 +1,235 @@
+#include "LocomotionRollback.h"
+
+namespace
+{
+	// FLocomotionFrameInput::Notify* bit order
+	constexpr ELocomotionEvent NotifyEvents[] = {
+		ELocomotionEvent::ApplyJumpForce,
+		ELocomotionEvent::TriggerFlip,
+		ELocomotionEvent::EndFlip,
+		ELocomotionEvent::StartProneTransition,
+		ELocomotionEvent::EndProneTransition
+	};
+
+	void TrackCapsule(const FLocomotionStanceChange& Change, float& CapsuleHalfHeight)
+	{
+		if (Change.bApply)
+		{
+			CapsuleHalfHeight = Change.CapsuleHalfHeight;
+		}
+	}
+
+	// The walk speed belongs to the movement component, only the state and capsule matter here
+	void HandleEvent(FLocomotionState& State, float& CapsuleHalfHeight, const FLocomotionSettings& Settings, ELocomotionEvent Event, FLocomotionEventContext& Context)
+	{
+		Context.CapsuleHalfHeight = CapsuleHalfHeight;
+		TrackCapsule(Locomotion::HandleEvent(State, Settings, Event, Context).StanceChange, CapsuleHalfHeight);
+	}
+}
+
+namespace LocomotionRollback
+{
+	FLocomotionSnapshot Capture(const FLocomotionState& State, float CapsuleHalfHeight)
+	{
+		FLocomotionSnapshot Snapshot;
+		Snapshot.JumpBufferDeadline = State.JumpBufferDeadline;
+		Snapshot.SlideVelocity = State.SlideVelocity;
+		Snapshot.MovementInput = State.MovementInput;
+		Snapshot.SlideFallTimer = State.SlideFallTimer;
+		Snapshot.SlideStartTimer = State.SlideStartTimer;
+		Snapshot.SlideStepAccumulator = State.SlideStepAccumulator;
+		Snapshot.CapsuleHalfHeight = CapsuleHalfHeight;
+		Snapshot.Stance = State.Stance;
+		Snapshot.JumpPhase = State.JumpPhase;
+		Snapshot.Flags =
+			(State.bIsRunning ? FLocomotionSnapshot::FlagRunning : 0) |
+			(State.bJumpInputQueued ? FLocomotionSnapshot::FlagJumpQueued : 0) |
+			(State.bJumpPending ? FLocomotionSnapshot::FlagJumpPending : 0);
+		Snapshot.JumpCount = static_cast<uint8_t>(State.JumpCount);
+		return Snapshot;
+	}
+
+	void Restore(const FLocomotionSnapshot& Snapshot, FLocomotionState& State, float& OutCapsuleHalfHeight)
+	{
+		State.Stance = Snapshot.Stance;
+		State.JumpPhase = Snapshot.JumpPhase;
+		State.bIsRunning = (Snapshot.Flags & FLocomotionSnapshot::FlagRunning) != 0;
+		State.bJumpInputQueued = (Snapshot.Flags & FLocomotionSnapshot::FlagJumpQueued) != 0;
+		State.bJumpPending = (Snapshot.Flags & FLocomotionSnapshot::FlagJumpPending) != 0;
+		State.JumpCount = Snapshot.JumpCount;
+		State.JumpBufferDeadline = Snapshot.JumpBufferDeadline;
+		State.SlideVelocity = Snapshot.SlideVelocity;
+		State.SlideFallTimer = Snapshot.SlideFallTimer;
+		State.SlideStartTimer = Snapshot.SlideStartTimer;
+		State.SlideStepAccumulator = Snapshot.SlideStepAccumulator;
+		State.MovementInput = Snapshot.MovementInput;
+		OutCapsuleHalfHeight = Snapshot.CapsuleHalfHeight;
+	}
+
+	void RecordEvent(FLocomotionFrameInput& Input, ELocomotionEvent Event, const FLocomotionEventContext& Context)
+	{
+		switch (Event)
+		{
+		case ELocomotionEvent::Move:
+			Input.bMoveInput = true;
+			Input.MovementInput = Context.MoveInput;
+			break;
+		case ELocomotionEvent::RunPressed: Input.bRunHeld = true; break;
+		case ELocomotionEvent::RunReleased: Input.bRunHeld = false; break;
+		case ELocomotionEvent::Dance: Input.bDancePressed = true; break;
+		case ELocomotionEvent::Jump: Input.bJumpPressed = true; break;
+		case ELocomotionEvent::CrouchPressed: Input.bCrouchPressed = true; break;
+		case ELocomotionEvent::CrouchReleased: Input.bCrouchReleased = true; break;
+		case ELocomotionEvent::Prone: Input.bPronePressed = true; break;
+		default:
+			for (uint8_t Bit = 0; Bit < sizeof(NotifyEvents) / sizeof(NotifyEvents[0]); ++Bit)
+			{
+				if (NotifyEvents[Bit] == Event)
+				{
+					Input.Notifies |= static_cast<uint8_t>(1u << Bit);
+				}
+			}
+			break;
+		}
+
+		if (Context.Queries & FLocomotionEventContext::QueryGround)
+		{
+			Input.GroundSpeed = Context.GroundSpeed;
+			Input.GroundDistance = Context.GroundDistance;
+		}
+		if (Context.Queries & FLocomotionEventContext::QueryClearance)
+		{
+			Input.bCanStand = Context.bCanStand;
+			Input.bCanCrouch = Context.bCanCrouch;
+		}
+	}
+
+	void SimulateFrame(FLocomotionState& State, float& CapsuleHalfHeight, const FLocomotionSettings& Settings, const FLocomotionFrameInput& Input, FLocomotionTickOutput& Output)
+	{
+		const FLocomotionTickInput& Tick = Input.Tick;
+
+		FLocomotionEventContext Context;
+		Context.Time = Tick.Time;
+		Context.bIsGrounded = Tick.bIsGrounded;
+		Context.bIsFalling = Tick.bIsFalling;
+		Context.ActorForward = Tick.ActorForward;
+		Context.MoveInput = Input.MovementInput;
+		Context.Queries = FLocomotionEventContext::QueryGround | FLocomotionEventContext::QueryClearance;
+		Context.GroundSpeed = Input.GroundSpeed;
+		Context.GroundDistance = Input.GroundDistance;
+		Context.bCanStand = Input.bCanStand;
+		Context.bCanCrouch = Input.bCanCrouch;
+
+		if (Input.bMoveInput)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, ELocomotionEvent::Move, Context);
+		}
+		if (Input.bRunHeld != State.bIsRunning)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, Input.bRunHeld ? ELocomotionEvent::RunPressed : ELocomotionEvent::RunReleased, Context);
+		}
+		if (Input.bDancePressed)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, ELocomotionEvent::Dance, Context);
+		}
+		if (Input.bJumpPressed)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, ELocomotionEvent::Jump, Context);
+		}
+		if (Input.bCrouchPressed)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, ELocomotionEvent::CrouchPressed, Context);
+		}
+		if (Input.bCrouchReleased)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, ELocomotionEvent::CrouchReleased, Context);
+		}
+		if (Input.bPronePressed)
+		{
+			HandleEvent(State, CapsuleHalfHeight, Settings, ELocomotionEvent::Prone, Context);
+		}
+		for (uint8_t Bit = 0; Bit < sizeof(NotifyEvents) / sizeof(NotifyEvents[0]); ++Bit)
+		{
+			if (Input.Notifies & (1u << Bit))
+			{
+				HandleEvent(State, CapsuleHalfHeight, Settings, NotifyEvents[Bit], Context);
+			}
+		}
+
+		Locomotion::Tick(State, Settings, Tick, Output);
+
+		if (Output.bExitSlide)
+		{
+			TrackCapsule(Locomotion::ExitSlide(State, Settings, Input.bCanStand, Input.bCanCrouch), CapsuleHalfHeight);
+		}
+	}
+}
+
+void FLocomotionRollbackBuffer::Record(uint32_t Frame, const FLocomotionSnapshot& Snapshot, const FLocomotionFrameInput& Input)
+{
+	FEntry& Entry = Entries[Frame % Capacity];
+	Entry.Snapshot = Snapshot;
+	Entry.Input = Input;
+	Entry.Frame = Frame;
+}
+
+bool FLocomotionRollbackBuffer::HasFrame(uint32_t Frame) const
+{
+	return Entries[Frame % Capacity].Frame == Frame;
+}
+
+const FLocomotionSnapshot* FLocomotionRollbackBuffer::FindSnapshot(uint32_t Frame) const
+{
+	const FEntry& Entry = Entries[Frame % Capacity];
+	return Entry.Frame == Frame ? &Entry.Snapshot : nullptr;
+}
+
+bool FLocomotionRollbackBuffer::SetInput(uint32_t Frame, const FLocomotionFrameInput& Input)
+{
+	FEntry& Entry = Entries[Frame % Capacity];
+	if (Entry.Frame != Frame)
+	{
+		return false;
+	}
+	Entry.Input = Input;
+	return true;
+}
+
+int32_t FLocomotionRollbackBuffer::Resimulate(uint32_t FromFrame, uint32_t EndFrame, FLocomotionState& State, float& CapsuleHalfHeight, const FLocomotionSettings& Settings)
+{
+	if (!HasFrame(FromFrame))
+	{
+		return 0;
+	}
+
+	LocomotionRollback::Restore(Entries[FromFrame % Capacity].Snapshot, State, CapsuleHalfHeight);
+
+	FLocomotionTickOutput Output;
+	int32_t NumFrames = 0;
+	for (uint32_t Frame = FromFrame; Frame != EndFrame; ++Frame)
+	{
+		FEntry& Entry = Entries[Frame % Capacity];
+		if (Entry.Frame != Frame)
+		{
+			break;
+		}
+
+		// The first snapshot is the one just restored, later ones may differ from what was recorded
+		if (Frame != FromFrame)
+		{
+			Entry.Snapshot = LocomotionRollback::Capture(State, CapsuleHalfHeight);
+		}
+
+		LocomotionRollback::SimulateFrame(State, CapsuleHalfHeight, Settings, Entry.Input, Output);
+		++NumFrames;
+	}
+	return NumFrames;
+}
+
+void FLocomotionRollbackBuffer::Reset()
+{
+	for (FEntry& Entry : Entries)
+	{
+		Entry.Frame = UINT32_MAX;
+	}
+}
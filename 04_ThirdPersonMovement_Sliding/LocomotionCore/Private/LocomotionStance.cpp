@@ -0,0 +1,31 @@
+#include "LocomotionStance.h"
+#include "LocomotionCore.h"
+
+namespace LocomotionStance
+{
+	const FLocomotionStanceInfo Infos[NumStances] =
+	{
+		// Parent      CapsuleHalfHeight                            MaxSpeed                            Jump   Sprint OwnsSpd QueueJmp BlockMove ProneTr
+		{ S,  &FLocomotionSettings::StandCapsuleHalfHeight,  &FLocomotionSettings::WalkSpeed,     true,  true,  false,  true,    false,    false },
+		{ S,  &FLocomotionSettings::StandCapsuleHalfHeight,  &FLocomotionSettings::WalkSpeed,     true,  true,  false,  false,   false,    false },
+		{ C,  &FLocomotionSettings::CrouchCapsuleHalfHeight, &FLocomotionSettings::CrouchSpeed,   false, false, false,  false,   false,    false },
+		{ C,  &FLocomotionSettings::CrouchCapsuleHalfHeight, &FLocomotionSettings::CrouchSpeed,   false, false, false,  false,   true,     true  },
+		{ P,  &FLocomotionSettings::ProneCapsuleHalfHeight,  &FLocomotionSettings::ProneSpeed,    false, false, false,  false,   false,    false },
+		{ P,  &FLocomotionSettings::ProneCapsuleHalfHeight,  &FLocomotionSettings::ProneSpeed,    false, false, false,  false,   true,     true  },
+		{ SL, &FLocomotionSettings::ProneCapsuleHalfHeight,  &FLocomotionSettings::MaxSlideSpeed, true,  false, true,   true,    false,    false },
+	};
+
+	bool CanReach(ELocomotionStance From, ELocomotionStance To)
+	{
+		const ELocomotionStance Parent = GetInfo(To).Parent;
+		for (int32_t Event = 0; Event < NumEvents; ++Event)
+		{
+			const ELocomotionStance Stance = Next(From, static_cast<ELocomotionStanceEvent>(Event));
+			if (Stance != Invalid && GetInfo(Stance).Parent == Parent)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+}
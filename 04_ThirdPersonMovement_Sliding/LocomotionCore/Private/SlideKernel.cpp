@@ -0,0 +1,273 @@
+#include "SlideKernel.h"
+#include "SlideKernelLanes.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#endif
+
+namespace
+{
+	struct FScalarOps
+	{
+		using FVec = float;
+		using FMask = bool;
+
+		static FVec Load(const float* Source) { return *Source; }
+		static void Store(float* Dest, FVec Value) { *Dest = Value; }
+		static FVec Set(float Value) { return Value; }
+
+		static FVec Add(FVec A, FVec B) { return A + B; }
+		static FVec Sub(FVec A, FVec B) { return A - B; }
+		static FVec Mul(FVec A, FVec B) { return A * B; }
+		static FVec Div(FVec A, FVec B) { return A / B; }
+		static FVec Sqrt(FVec A) { return std::sqrt(A); }
+		static FVec Neg(FVec A) { return -A; }
+		static FVec Pow(FVec A, float Exponent) { return std::pow(A, Exponent); }
+
+		static FMask Less(FVec A, FVec B) { return A < B; }
+		static FMask LessEqual(FVec A, FVec B) { return A <= B; }
+		static FMask Greater(FVec A, FVec B) { return A > B; }
+		static FMask And(FMask A, FMask B) { return A && B; }
+		static FMask Or(FMask A, FMask B) { return A || B; }
+		static FMask Not(FMask A) { return !A; }
+		static FVec Select(FMask Mask, FVec IfTrue, FVec IfFalse) { return Mask ? IfTrue : IfFalse; }
+
+		static FMask LoadFlags(const uint8_t* Source) { return *Source != 0; }
+		static void StoreFlags(uint8_t* Dest, FMask Mask) { *Dest = Mask ? 1 : 0; }
+	};
+
+	bool CpuSupports(ESlideKernelPath Path)
+	{
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+		if (Path == ESlideKernelPath::SSE41)
+		{
+			return __builtin_cpu_supports("sse4.1");
+		}
+		if (Path == ESlideKernelPath::AVX2)
+		{
+			return __builtin_cpu_supports("avx2");
+		}
+		return Path == ESlideKernelPath::Scalar;
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+		int CpuInfo[4] = {};
+		__cpuid(CpuInfo, 1);
+		const bool bSSE41 = (CpuInfo[2] & (1 << 19)) != 0;
+		const bool bOSXSave = (CpuInfo[2] & (1 << 27)) != 0;
+		const bool bAVX = (CpuInfo[2] & (1 << 28)) != 0;
+		if (Path == ESlideKernelPath::SSE41)
+		{
+			return bSSE41;
+		}
+		if (Path == ESlideKernelPath::AVX2)
+		{
+			if (!bOSXSave || !bAVX || (_xgetbv(0) & 0x6) != 0x6)
+			{
+				return false;
+			}
+			__cpuidex(CpuInfo, 7, 0);
+			return (CpuInfo[1] & (1 << 5)) != 0;
+		}
+		return Path == ESlideKernelPath::Scalar;
+#else
+		return Path == ESlideKernelPath::Scalar;
+#endif
+	}
+
+	FSlideBatchView MakeView(FSlideBatch& Batch)
+	{
+		FSlideBatchView View;
+		View.VelocityX = Batch.VelocityX.data();
+		View.VelocityY = Batch.VelocityY.data();
+		View.VelocityZ = Batch.VelocityZ.data();
+		View.FallTimer = Batch.FallTimer.data();
+		View.StartTimer = Batch.StartTimer.data();
+		View.GroundNormalX = Batch.GroundNormalX.data();
+		View.GroundNormalY = Batch.GroundNormalY.data();
+		View.GroundNormalZ = Batch.GroundNormalZ.data();
+		View.ForwardX = Batch.ForwardX.data();
+		View.ForwardY = Batch.ForwardY.data();
+		View.ForwardZ = Batch.ForwardZ.data();
+		View.HasGroundHit = Batch.HasGroundHit.data();
+		View.IsGrounded = Batch.IsGrounded.data();
+		View.IsRunning = Batch.IsRunning.data();
+		View.MoveDirectionX = Batch.MoveDirectionX.data();
+		View.MoveDirectionY = Batch.MoveDirectionY.data();
+		View.MoveDirectionZ = Batch.MoveDirectionZ.data();
+		View.MoveScale = Batch.MoveScale.data();
+		View.ExitSlide = Batch.ExitSlide.data();
+		View.Num = Batch.Num();
+		return View;
+	}
+
+	FSlideKernelConstants MakeConstants(const FLocomotionSettings& Settings, float DeltaTime)
+	{
+		FSlideKernelConstants Constants;
+		Constants.DeltaTime = DeltaTime;
+		Constants.MinSlideSpeed = Settings.MinSlideSpeed;
+		Constants.HalfMinSlideSpeed = Settings.MinSlideSpeed * 0.5f;
+		Constants.RampBoostStep = Settings.RampBoostSpeed * DeltaTime;
+		Constants.UphillPenaltyExponent = Settings.UphillPenaltyReferenceRate > 0.f ? DeltaTime * Settings.UphillPenaltyReferenceRate : 1.f;
+		Constants.FlatSlideBoost = Settings.FlatSlideBoost;
+		Constants.FlatInterpAlpha = LocomotionMath::Clamp(DeltaTime * 3.0f, 0.f, 1.f);
+		Constants.FrictionAlpha = LocomotionMath::Clamp(DeltaTime * Settings.SlideFriction, 0.f, 1.f);
+		Constants.bFrictionSnapsToZero = Settings.SlideFriction <= 0.f;
+		Constants.MaxSlideSpeed = Settings.MaxSlideSpeed;
+		Constants.MaxSlideSpeedSquared = Settings.MaxSlideSpeed * Settings.MaxSlideSpeed;
+		Constants.bClampSlideToZero = Settings.MaxSlideSpeed < LocomotionMath::KindaSmallNumber;
+		Constants.SlideFallGraceTime = Settings.SlideFallGraceTime;
+		Constants.MoveDeltaTime = DeltaTime;
+		Constants.bSkipExitedLanes = false;
+		return Constants;
+	}
+
+	// Path is already resolved
+	void StepLanes(const FSlideBatchView& View, const FSlideKernelConstants& Constants, ESlideKernelPath Path)
+	{
+		int32_t Processed = 0;
+		switch (Path)
+		{
+		case ESlideKernelPath::AVX2:
+			Processed = StepSlideBatchAVX2(View, Constants);
+			break;
+		case ESlideKernelPath::SSE41:
+			Processed = StepSlideBatchSSE41(View, Constants);
+			break;
+		default:
+			break;
+		}
+
+		// Scalar path and the tail the vector paths left over
+		for (int32_t Index = Processed; Index < View.Num; ++Index)
+		{
+			SlideKernelLanes::StepSlideLanes<FScalarOps>(View, Index, Constants);
+		}
+	}
+}
+
+void FSlideBatch::Resize(int32_t NewNum)
+{
+	const size_t Size = static_cast<size_t>(NewNum);
+
+	VelocityX.resize(Size);
+	VelocityY.resize(Size);
+	VelocityZ.resize(Size);
+	FallTimer.resize(Size);
+	StartTimer.resize(Size);
+
+	GroundNormalX.resize(Size);
+	GroundNormalY.resize(Size);
+	GroundNormalZ.resize(Size, 1.f);
+	ForwardX.resize(Size, 1.f);
+	ForwardY.resize(Size);
+	ForwardZ.resize(Size);
+	HasGroundHit.resize(Size);
+	IsGrounded.resize(Size);
+	IsRunning.resize(Size);
+
+	MoveDirectionX.resize(Size);
+	MoveDirectionY.resize(Size);
+	MoveDirectionZ.resize(Size);
+	MoveScale.resize(Size);
+	ExitSlide.resize(Size);
+}
+
+void FSlideBatch::LoadLane(int32_t Index, const FLocomotionState& State, const FLocomotionTickInput& Input)
+{
+	VelocityX[Index] = State.SlideVelocity.X;
+	VelocityY[Index] = State.SlideVelocity.Y;
+	VelocityZ[Index] = State.SlideVelocity.Z;
+	FallTimer[Index] = State.SlideFallTimer;
+	StartTimer[Index] = State.SlideStartTimer;
+
+	GroundNormalX[Index] = Input.SlideGroundNormal.X;
+	GroundNormalY[Index] = Input.SlideGroundNormal.Y;
+	GroundNormalZ[Index] = Input.SlideGroundNormal.Z;
+	ForwardX[Index] = Input.ActorForward.X;
+	ForwardY[Index] = Input.ActorForward.Y;
+	ForwardZ[Index] = Input.ActorForward.Z;
+	HasGroundHit[Index] = Input.bHasSlideGroundHit ? 1 : 0;
+	IsGrounded[Index] = Input.bIsGrounded ? 1 : 0;
+	IsRunning[Index] = State.bIsRunning ? 1 : 0;
+}
+
+void FSlideBatch::StoreLane(int32_t Index, const FLocomotionSettings& Settings, FLocomotionState& State, FLocomotionTickOutput& Output) const
+{
+	State.SlideVelocity = FLocomotionVector(VelocityX[Index], VelocityY[Index], VelocityZ[Index]);
+	State.SlideFallTimer = FallTimer[Index];
+	State.SlideStartTimer = StartTimer[Index];
+
+	Output = FLocomotionTickOutput();
+	Output.bSetMaxWalkSpeed = true;
+	Output.MaxWalkSpeed = Settings.MaxSlideSpeed;
+	Output.bApplySlideMovement = true;
+	Output.SlideMoveDirection = FLocomotionVector(MoveDirectionX[Index], MoveDirectionY[Index], MoveDirectionZ[Index]);
+	Output.SlideMoveScale = MoveScale[Index];
+	Output.bExitSlide = ExitSlide[Index] != 0;
+}
+
+namespace SlideKernel
+{
+	bool IsPathSupported(ESlideKernelPath Path)
+	{
+		switch (Path)
+		{
+		case ESlideKernelPath::Auto:
+		case ESlideKernelPath::Scalar:
+			return true;
+		case ESlideKernelPath::SSE41:
+			return IsSlideKernelSSE41Compiled() && CpuSupports(ESlideKernelPath::SSE41);
+		case ESlideKernelPath::AVX2:
+			return IsSlideKernelAVX2Compiled() && CpuSupports(ESlideKernelPath::AVX2);
+		}
+		return false;
+	}
+
+	ESlideKernelPath ResolvePath(ESlideKernelPath Path)
+	{
+		if (Path == ESlideKernelPath::Auto)
+		{
+			static const ESlideKernelPath BestPath =
+				IsPathSupported(ESlideKernelPath::AVX2) ? ESlideKernelPath::AVX2 :
+				IsPathSupported(ESlideKernelPath::SSE41) ? ESlideKernelPath::SSE41 :
+				ESlideKernelPath::Scalar;
+			return BestPath;
+		}
+		return IsPathSupported(Path) ? Path : ESlideKernelPath::Scalar;
+	}
+
+	const char* GetPathName(ESlideKernelPath Path)
+	{
+		switch (Path)
+		{
+		case ESlideKernelPath::Auto: return "Auto";
+		case ESlideKernelPath::Scalar: return "Scalar";
+		case ESlideKernelPath::SSE41: return "SSE4.1";
+		case ESlideKernelPath::AVX2: return "AVX2";
+		}
+		return "Unknown";
+	}
+
+	void Step(FSlideBatch& Batch, const FLocomotionSettings& Settings, float DeltaTime, ESlideKernelPath Path)
+	{
+		// Without a fixed rate, split long ticks the way Locomotion::Tick does
+		int32_t Steps = 1;
+		if (Settings.SlideFixedStepRate <= 0.f && Settings.MaxSlideStepTime > 0.f && DeltaTime > Settings.MaxSlideStepTime)
+		{
+			Steps = std::min(static_cast<int32_t>(std::ceil(DeltaTime / Settings.MaxSlideStepTime)), std::max(Settings.MaxSlideSubsteps, 1));
+		}
+
+		const FSlideBatchView View = MakeView(Batch);
+		FSlideKernelConstants Constants = MakeConstants(Settings, DeltaTime / static_cast<float>(Steps));
+		Constants.MoveDeltaTime = DeltaTime;
+
+		const ESlideKernelPath ResolvedPath = ResolvePath(Path);
+		for (int32_t Index = 0; Index < Steps; ++Index)
+		{
+			Constants.bSkipExitedLanes = Index > 0;
+			StepLanes(View, Constants, ResolvedPath);
+		}
+	}
+}
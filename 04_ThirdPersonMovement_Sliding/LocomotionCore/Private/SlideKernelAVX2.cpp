@@ -0,0 +1,97 @@
+// AVX2 path of the batched slide kernel. Built with AVX2 enabled, only entered after a CPU check.
+
+#include "SlideKernelLanes.h"
+
+#if defined(__AVX2__)
+#define LOCOMOTION_SLIDE_KERNEL_AVX2 1
+#include <immintrin.h>
+#include <math.h>
+#else
+#define LOCOMOTION_SLIDE_KERNEL_AVX2 0
+#endif
+
+#if LOCOMOTION_SLIDE_KERNEL_AVX2
+
+namespace
+{
+	struct FAVX2Ops
+	{
+		using FVec = __m256;
+		using FMask = __m256;
+
+		static FVec Load(const float* Source) { return _mm256_loadu_ps(Source); }
+		static void Store(float* Dest, FVec Value) { _mm256_storeu_ps(Dest, Value); }
+		static FVec Set(float Value) { return _mm256_set1_ps(Value); }
+
+		static FVec Add(FVec A, FVec B) { return _mm256_add_ps(A, B); }
+		static FVec Sub(FVec A, FVec B) { return _mm256_sub_ps(A, B); }
+		static FVec Mul(FVec A, FVec B) { return _mm256_mul_ps(A, B); }
+		static FVec Div(FVec A, FVec B) { return _mm256_div_ps(A, B); }
+		static FVec Sqrt(FVec A) { return _mm256_sqrt_ps(A); }
+		// Per lane through the C library so the result matches the scalar path
+		static FVec Pow(FVec A, float Exponent)
+		{
+			alignas(32) float Lanes[8];
+			_mm256_store_ps(Lanes, A);
+			for (float& Lane : Lanes)
+			{
+				Lane = powf(Lane, Exponent);
+			}
+			return _mm256_load_ps(Lanes);
+		}
+
+		static FVec Neg(FVec A) { return _mm256_xor_ps(A, _mm256_set1_ps(-0.f)); }
+
+		static FMask Less(FVec A, FVec B) { return _mm256_cmp_ps(A, B, _CMP_LT_OQ); }
+		static FMask LessEqual(FVec A, FVec B) { return _mm256_cmp_ps(A, B, _CMP_LE_OQ); }
+		static FMask Greater(FVec A, FVec B) { return _mm256_cmp_ps(A, B, _CMP_GT_OQ); }
+		static FMask And(FMask A, FMask B) { return _mm256_and_ps(A, B); }
+		static FMask Or(FMask A, FMask B) { return _mm256_or_ps(A, B); }
+		static FMask Not(FMask A) { return _mm256_xor_ps(A, _mm256_castsi256_ps(_mm256_set1_epi32(-1))); }
+		static FVec Select(FMask Mask, FVec IfTrue, FVec IfFalse) { return _mm256_blendv_ps(IfFalse, IfTrue, Mask); }
+
+		static FMask LoadFlags(const uint8_t* Source)
+		{
+			const __m256i Wide = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(Source)));
+			return _mm256_castsi256_ps(_mm256_cmpgt_epi32(Wide, _mm256_setzero_si256()));
+		}
+
+		static void StoreFlags(uint8_t* Dest, FMask Mask)
+		{
+			const int Bits = _mm256_movemask_ps(Mask);
+			for (int Lane = 0; Lane < 8; ++Lane)
+			{
+				Dest[Lane] = static_cast<uint8_t>((Bits >> Lane) & 1);
+			}
+		}
+	};
+}
+
+int32_t StepSlideBatchAVX2(const FSlideBatchView& View, const FSlideKernelConstants& Constants)
+{
+	const int32_t VectorNum = View.Num & ~7;
+	for (int32_t Index = 0; Index < VectorNum; Index += 8)
+	{
+		SlideKernelLanes::StepSlideLanes<FAVX2Ops>(View, Index, Constants);
+	}
+	return VectorNum;
+}
+
+bool IsSlideKernelAVX2Compiled()
+{
+	return true;
+}
+
+#else
+
+int32_t StepSlideBatchAVX2(const FSlideBatchView&, const FSlideKernelConstants&)
+{
+	return 0;
+}
+
+bool IsSlideKernelAVX2Compiled()
+{
+	return false;
+}
+
+#endif
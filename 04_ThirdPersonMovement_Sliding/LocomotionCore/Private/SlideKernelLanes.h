@@ -0,0 +1,279 @@
+#pragma once
+
+#include <cstdint>
+#include "LocomotionMath.h"
+
+/**
+ * Shared body of the batched slide kernel.
+ * StepSlideLanes is written once against a small lane-ops interface (scalar float, SSE4.1, AVX2),
+ * so every path performs the same IEEE operations in the same order as Locomotion::Tick.
+ * Pow goes through the C library's powf on every path, the same call std::pow makes for floats.
+ * Only constexpr values are used from the math header: the SIMD translation units are built with
+ * wider ISA flags and must not emit copies of shared inline functions.
+ */
+
+// Raw pointers into an FSlideBatch, built by the scalar translation unit
+struct FSlideBatchView
+{
+	float* VelocityX;
+	float* VelocityY;
+	float* VelocityZ;
+	float* FallTimer;
+	float* StartTimer;
+
+	const float* GroundNormalX;
+	const float* GroundNormalY;
+	const float* GroundNormalZ;
+	const float* ForwardX;
+	const float* ForwardY;
+	const float* ForwardZ;
+	const uint8_t* HasGroundHit;
+	const uint8_t* IsGrounded;
+	const uint8_t* IsRunning;
+
+	float* MoveDirectionX;
+	float* MoveDirectionY;
+	float* MoveDirectionZ;
+	float* MoveScale;
+	uint8_t* ExitSlide;
+
+	int32_t Num;
+};
+
+// Values that are uniform across the batch, folded once per step exactly as Locomotion::Tick computes them
+struct FSlideKernelConstants
+{
+	float DeltaTime;
+	float MinSlideSpeed;
+	float HalfMinSlideSpeed;
+	float RampBoostStep;
+	float UphillPenaltyExponent;
+	float FlatSlideBoost;
+	float FlatInterpAlpha;
+	float FrictionAlpha;
+	bool bFrictionSnapsToZero;
+	float MaxSlideSpeed;
+	float MaxSlideSpeedSquared;
+	bool bClampSlideToZero;
+	float SlideFallGraceTime;
+	// Whole tick the move scale covers, longer than DeltaTime when the tick is split into steps
+	float MoveDeltaTime;
+	// Set on every step of a split tick after the first, lanes that already exited keep the exit step's results
+	bool bSkipExitedLanes;
+};
+
+// Entry points of the ISA-specific translation units. Each returns how many lanes it processed from the start of the batch
+int32_t StepSlideBatchSSE41(const FSlideBatchView& View, const FSlideKernelConstants& Constants);
+int32_t StepSlideBatchAVX2(const FSlideBatchView& View, const FSlideKernelConstants& Constants);
+bool IsSlideKernelSSE41Compiled();
+bool IsSlideKernelAVX2Compiled();
+
+namespace SlideKernelLanes
+{
+	template<typename Ops>
+	static inline typename Ops::FVec Clamp(typename Ops::FVec Value, float Min, float Max)
+	{
+		const typename Ops::FVec MinVec = Ops::Set(Min);
+		const typename Ops::FVec MaxVec = Ops::Set(Max);
+		return Ops::Select(Ops::Less(Value, MinVec), MinVec, Ops::Select(Ops::Less(Value, MaxVec), Value, MaxVec));
+	}
+
+	template<typename Ops>
+	static inline typename Ops::FVec Acos(typename Ops::FVec Value)
+	{
+		using FVec = typename Ops::FVec;
+		using FMask = typename Ops::FMask;
+
+		const FVec X = Clamp<Ops>(Value, -1.f, 1.f);
+		const FMask bNegative = Ops::Less(X, Ops::Set(0.f));
+		const FVec AbsX = Ops::Select(bNegative, Ops::Neg(X), X);
+
+		FVec Poly = Ops::Set(LocomotionMath::AcosCoefficients[7]);
+		for (int Index = 6; Index >= 0; --Index)
+		{
+			Poly = Ops::Add(Ops::Mul(Poly, AbsX), Ops::Set(LocomotionMath::AcosCoefficients[Index]));
+		}
+
+		const FVec Result = Ops::Mul(Ops::Sqrt(Ops::Sub(Ops::Set(1.f), AbsX)), Poly);
+		return Ops::Select(bNegative, Ops::Sub(Ops::Set(LocomotionMath::Pi), Result), Result);
+	}
+
+	template<typename Ops>
+	static inline typename Ops::FVec SizeSquared(typename Ops::FVec X, typename Ops::FVec Y, typename Ops::FVec Z)
+	{
+		return Ops::Add(Ops::Add(Ops::Mul(X, X), Ops::Mul(Y, Y)), Ops::Mul(Z, Z));
+	}
+
+	template<typename Ops>
+	static inline void SafeNormal(typename Ops::FVec& X, typename Ops::FVec& Y, typename Ops::FVec& Z)
+	{
+		using FVec = typename Ops::FVec;
+
+		const FVec SquareSum = SizeSquared<Ops>(X, Y, Z);
+		const typename Ops::FMask bTooSmall = Ops::Less(SquareSum, Ops::Set(LocomotionMath::SmallNumber));
+		const FVec Scale = Ops::Div(Ops::Set(1.f), Ops::Sqrt(SquareSum));
+		const FVec Zero = Ops::Set(0.f);
+
+		X = Ops::Select(bTooSmall, Zero, Ops::Mul(X, Scale));
+		Y = Ops::Select(bTooSmall, Zero, Ops::Mul(Y, Scale));
+		Z = Ops::Select(bTooSmall, Zero, Ops::Mul(Z, Scale));
+	}
+
+	template<typename Ops>
+	static inline void StoreActive(float* Dest, typename Ops::FVec Value, typename Ops::FMask bExited, bool bMasked)
+	{
+		Ops::Store(Dest, bMasked ? Ops::Select(bExited, Ops::Load(Dest), Value) : Value);
+	}
+
+	// FMath::VInterpTo with a positive, batch-uniform interp speed folded into Alpha
+	template<typename Ops>
+	static inline void VInterpTo(typename Ops::FVec& X, typename Ops::FVec& Y, typename Ops::FVec& Z,
+		typename Ops::FVec TargetX, typename Ops::FVec TargetY, typename Ops::FVec TargetZ, float Alpha)
+	{
+		using FVec = typename Ops::FVec;
+
+		const FVec DistX = Ops::Sub(TargetX, X);
+		const FVec DistY = Ops::Sub(TargetY, Y);
+		const FVec DistZ = Ops::Sub(TargetZ, Z);
+		const typename Ops::FMask bSnap = Ops::Less(SizeSquared<Ops>(DistX, DistY, DistZ), Ops::Set(LocomotionMath::KindaSmallNumber));
+		const FVec AlphaVec = Ops::Set(Alpha);
+
+		X = Ops::Select(bSnap, TargetX, Ops::Add(X, Ops::Mul(DistX, AlphaVec)));
+		Y = Ops::Select(bSnap, TargetY, Ops::Add(Y, Ops::Mul(DistY, AlphaVec)));
+		Z = Ops::Select(bSnap, TargetZ, Ops::Add(Z, Ops::Mul(DistZ, AlphaVec)));
+	}
+
+	template<typename Ops>
+	static inline void StepSlideLanes(const FSlideBatchView& View, int32_t Index, const FSlideKernelConstants& Constants)
+	{
+		using FVec = typename Ops::FVec;
+		using FMask = typename Ops::FMask;
+
+		const FVec Zero = Ops::Set(0.f);
+		const FVec One = Ops::Set(1.f);
+		const FVec DeltaTime = Ops::Set(Constants.DeltaTime);
+		const bool bMasked = Constants.bSkipExitedLanes;
+		const FMask bExited = bMasked ? Ops::LoadFlags(View.ExitSlide + Index) : Ops::Less(Zero, Zero);
+
+		FVec VelX = Ops::Load(View.VelocityX + Index);
+		FVec VelY = Ops::Load(View.VelocityY + Index);
+		FVec VelZ = Ops::Load(View.VelocityZ + Index);
+
+		const FMask bHasHit = Ops::LoadFlags(View.HasGroundHit + Index);
+		const FVec NormalX = Ops::Load(View.GroundNormalX + Index);
+		const FVec NormalY = Ops::Load(View.GroundNormalY + Index);
+		const FVec NormalZ = Ops::Load(View.GroundNormalZ + Index);
+
+		// Incline = Dot(GroundNormal, Up)
+		const FVec Incline = Ops::Add(Ops::Add(Ops::Mul(NormalX, Zero), Ops::Mul(NormalY, Zero)), Ops::Mul(NormalZ, One));
+		const FVec SlopeAngle = Ops::Mul(Acos<Ops>(Incline), Ops::Set(180.f / LocomotionMath::Pi));
+
+		// DownhillDir = Cross(GroundNormal, Cross(Up, GroundNormal)).GetSafeNormal()
+		const FVec CrossX = Ops::Sub(Ops::Mul(Zero, NormalZ), Ops::Mul(One, NormalY));
+		const FVec CrossY = Ops::Sub(Ops::Mul(One, NormalX), Ops::Mul(Zero, NormalZ));
+		const FVec CrossZ = Ops::Sub(Ops::Mul(Zero, NormalY), Ops::Mul(Zero, NormalX));
+		FVec DownX = Ops::Sub(Ops::Mul(NormalY, CrossZ), Ops::Mul(NormalZ, CrossY));
+		FVec DownY = Ops::Sub(Ops::Mul(NormalZ, CrossX), Ops::Mul(NormalX, CrossZ));
+		FVec DownZ = Ops::Sub(Ops::Mul(NormalX, CrossY), Ops::Mul(NormalY, CrossX));
+		SafeNormal<Ops>(DownX, DownY, DownZ);
+
+		FVec DirX = VelX;
+		FVec DirY = VelY;
+		FVec DirZ = VelZ;
+		SafeNormal<Ops>(DirX, DirY, DirZ);
+		const FVec Alignment = Ops::Add(Ops::Add(Ops::Mul(DirX, DownX), Ops::Mul(DirY, DownY)), Ops::Mul(DirZ, DownZ));
+
+		// Downhill boost
+		const FMask bDownhillAligned = Ops::And(bHasHit, Ops::And(Ops::Greater(SlopeAngle, Ops::Set(10.f)), Ops::Less(Alignment, Ops::Set(0.5f))));
+		const FVec BoostScale = Clamp<Ops>(Ops::Mul(Ops::Sub(One, Alignment), Ops::Div(SlopeAngle, Ops::Set(30.f))), 0.5f, 2.5f);
+		const FVec BoostStep = Ops::Mul(Ops::Set(Constants.RampBoostStep), BoostScale);
+		VelX = Ops::Select(bDownhillAligned, Ops::Add(VelX, Ops::Mul(DownX, BoostStep)), VelX);
+		VelY = Ops::Select(bDownhillAligned, Ops::Add(VelY, Ops::Mul(DownY, BoostStep)), VelY);
+		VelZ = Ops::Select(bDownhillAligned, Ops::Add(VelZ, Ops::Mul(DownZ, BoostStep)), VelZ);
+
+		// Uphill penalty
+		const FMask bUphill = Ops::And(bHasHit, Ops::Greater(Alignment, Zero));
+		FVec PenaltyScale = Ops::Sub(One, Ops::Mul(Clamp<Ops>(Alignment, 0.2f, 1.f), Ops::Set(0.5f)));
+		if (Constants.UphillPenaltyExponent != 1.f)
+		{
+			PenaltyScale = Ops::Pow(PenaltyScale, Constants.UphillPenaltyExponent);
+		}
+		VelX = Ops::Select(bUphill, Ops::Mul(VelX, PenaltyScale), VelX);
+		VelY = Ops::Select(bUphill, Ops::Mul(VelY, PenaltyScale), VelY);
+		VelZ = Ops::Select(bUphill, Ops::Mul(VelZ, PenaltyScale), VelZ);
+
+		// Exit threshold, halved on downhill slides
+		const FVec ExitThreshold = Ops::Select(bDownhillAligned, Ops::Set(Constants.HalfMinSlideSpeed), Ops::Set(Constants.MinSlideSpeed));
+
+		// Flat boost scaled and interpolated
+		const FVec FlatBoost = Ops::Mul(Ops::Set(Constants.FlatSlideBoost), Clamp<Ops>(Ops::Sub(One, Alignment), 0.f, 1.f));
+		FVec FlatX = VelX;
+		FVec FlatY = VelY;
+		FVec FlatZ = VelZ;
+		VInterpTo<Ops>(FlatX, FlatY, FlatZ,
+			Ops::Mul(Ops::Load(View.ForwardX + Index), FlatBoost),
+			Ops::Mul(Ops::Load(View.ForwardY + Index), FlatBoost),
+			Ops::Mul(Ops::Load(View.ForwardZ + Index), FlatBoost),
+			Constants.FlatInterpAlpha);
+		VelX = Ops::Select(bHasHit, FlatX, VelX);
+		VelY = Ops::Select(bHasHit, FlatY, VelY);
+		VelZ = Ops::Select(bHasHit, FlatZ, VelZ);
+
+		// Clamp max slide speed
+		if (Constants.bClampSlideToZero)
+		{
+			VelX = Zero;
+			VelY = Zero;
+			VelZ = Zero;
+		}
+		else
+		{
+			const FVec VelSq = SizeSquared<Ops>(VelX, VelY, VelZ);
+			const FMask bTooFast = Ops::Greater(VelSq, Ops::Set(Constants.MaxSlideSpeedSquared));
+			const FVec ClampScale = Ops::Div(Ops::Set(Constants.MaxSlideSpeed), Ops::Sqrt(VelSq));
+			VelX = Ops::Select(bTooFast, Ops::Mul(VelX, ClampScale), VelX);
+			VelY = Ops::Select(bTooFast, Ops::Mul(VelY, ClampScale), VelY);
+			VelZ = Ops::Select(bTooFast, Ops::Mul(VelZ, ClampScale), VelZ);
+		}
+
+		// Movement request
+		const FVec Speed = Ops::Sqrt(SizeSquared<Ops>(VelX, VelY, VelZ));
+		FVec MoveX = VelX;
+		FVec MoveY = VelY;
+		FVec MoveZ = VelZ;
+		SafeNormal<Ops>(MoveX, MoveY, MoveZ);
+		StoreActive<Ops>(View.MoveDirectionX + Index, MoveX, bExited, bMasked);
+		StoreActive<Ops>(View.MoveDirectionY + Index, MoveY, bExited, bMasked);
+		StoreActive<Ops>(View.MoveDirectionZ + Index, MoveZ, bExited, bMasked);
+		StoreActive<Ops>(View.MoveScale + Index, Ops::Mul(Speed, Ops::Set(Constants.MoveDeltaTime)), bExited, bMasked);
+
+		// Airborne and grace timers
+		const FMask bGrounded = Ops::LoadFlags(View.IsGrounded + Index);
+		const FVec FallTimer = Ops::Select(bGrounded, Zero, Ops::Add(Ops::Load(View.FallTimer + Index), DeltaTime));
+		const FVec PrevStartTimer = Ops::Load(View.StartTimer + Index);
+		const FVec StartTimer = Ops::Select(Ops::Greater(PrevStartTimer, Zero), Ops::Sub(PrevStartTimer, DeltaTime), PrevStartTimer);
+		StoreActive<Ops>(View.FallTimer + Index, FallTimer, bExited, bMasked);
+		StoreActive<Ops>(View.StartTimer + Index, StartTimer, bExited, bMasked);
+
+		// Exit slide conditions
+		const FMask bSlowed = Ops::And(Ops::Less(Speed, ExitThreshold), Ops::Not(bDownhillAligned));
+		const FMask bExitReason = Ops::Or(Ops::Or(bSlowed, Ops::Greater(FallTimer, Ops::Set(Constants.SlideFallGraceTime))), Ops::Not(Ops::LoadFlags(View.IsRunning + Index)));
+		const FMask bExit = Ops::And(Ops::LessEqual(StartTimer, Zero), bExitReason);
+		Ops::StoreFlags(View.ExitSlide + Index, bMasked ? Ops::Or(bExited, bExit) : bExit);
+
+		// Friction, skipped on the exit frame like Locomotion::Tick
+		FVec FrictionX = Zero;
+		FVec FrictionY = Zero;
+		FVec FrictionZ = Zero;
+		if (!Constants.bFrictionSnapsToZero)
+		{
+			FrictionX = VelX;
+			FrictionY = VelY;
+			FrictionZ = VelZ;
+			VInterpTo<Ops>(FrictionX, FrictionY, FrictionZ, Zero, Zero, Zero, Constants.FrictionAlpha);
+		}
+		StoreActive<Ops>(View.VelocityX + Index, Ops::Select(bExit, VelX, FrictionX), bExited, bMasked);
+		StoreActive<Ops>(View.VelocityY + Index, Ops::Select(bExit, VelY, FrictionY), bExited, bMasked);
+		StoreActive<Ops>(View.VelocityZ + Index, Ops::Select(bExit, VelZ, FrictionZ), bExited, bMasked);
+	}
+}
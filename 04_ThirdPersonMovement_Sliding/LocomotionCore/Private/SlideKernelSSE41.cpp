@@ -0,0 +1,100 @@
+// SSE4.1 path of the batched slide kernel. Built with SSE4.1 enabled, only entered after a CPU check.
+
+#include "SlideKernelLanes.h"
+
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86)))
+#define LOCOMOTION_SLIDE_KERNEL_SSE41 1
+#include <smmintrin.h>
+#include <math.h>
+#include <cstring>
+#else
+#define LOCOMOTION_SLIDE_KERNEL_SSE41 0
+#endif
+
+#if LOCOMOTION_SLIDE_KERNEL_SSE41
+
+namespace
+{
+	struct FSSE41Ops
+	{
+		using FVec = __m128;
+		using FMask = __m128;
+
+		static FVec Load(const float* Source) { return _mm_loadu_ps(Source); }
+		static void Store(float* Dest, FVec Value) { _mm_storeu_ps(Dest, Value); }
+		static FVec Set(float Value) { return _mm_set1_ps(Value); }
+
+		static FVec Add(FVec A, FVec B) { return _mm_add_ps(A, B); }
+		static FVec Sub(FVec A, FVec B) { return _mm_sub_ps(A, B); }
+		static FVec Mul(FVec A, FVec B) { return _mm_mul_ps(A, B); }
+		static FVec Div(FVec A, FVec B) { return _mm_div_ps(A, B); }
+		static FVec Sqrt(FVec A) { return _mm_sqrt_ps(A); }
+		// Per lane through the C library so the result matches the scalar path
+		static FVec Pow(FVec A, float Exponent)
+		{
+			alignas(16) float Lanes[4];
+			_mm_store_ps(Lanes, A);
+			for (float& Lane : Lanes)
+			{
+				Lane = powf(Lane, Exponent);
+			}
+			return _mm_load_ps(Lanes);
+		}
+
+		static FVec Neg(FVec A) { return _mm_xor_ps(A, _mm_set1_ps(-0.f)); }
+
+		static FMask Less(FVec A, FVec B) { return _mm_cmplt_ps(A, B); }
+		static FMask LessEqual(FVec A, FVec B) { return _mm_cmple_ps(A, B); }
+		static FMask Greater(FVec A, FVec B) { return _mm_cmpgt_ps(A, B); }
+		static FMask And(FMask A, FMask B) { return _mm_and_ps(A, B); }
+		static FMask Or(FMask A, FMask B) { return _mm_or_ps(A, B); }
+		static FMask Not(FMask A) { return _mm_xor_ps(A, _mm_castsi128_ps(_mm_set1_epi32(-1))); }
+		static FVec Select(FMask Mask, FVec IfTrue, FVec IfFalse) { return _mm_blendv_ps(IfFalse, IfTrue, Mask); }
+
+		static FMask LoadFlags(const uint8_t* Source)
+		{
+			int32_t Bytes;
+			std::memcpy(&Bytes, Source, sizeof(Bytes));
+			const __m128i Wide = _mm_cvtepu8_epi32(_mm_cvtsi32_si128(Bytes));
+			return _mm_castsi128_ps(_mm_cmpgt_epi32(Wide, _mm_setzero_si128()));
+		}
+
+		static void StoreFlags(uint8_t* Dest, FMask Mask)
+		{
+			const int Bits = _mm_movemask_ps(Mask);
+			for (int Lane = 0; Lane < 4; ++Lane)
+			{
+				Dest[Lane] = static_cast<uint8_t>((Bits >> Lane) & 1);
+			}
+		}
+	};
+}
+
+int32_t StepSlideBatchSSE41(const FSlideBatchView& View, const FSlideKernelConstants& Constants)
+{
+	const int32_t VectorNum = View.Num & ~3;
+	for (int32_t Index = 0; Index < VectorNum; Index += 4)
+	{
+		SlideKernelLanes::StepSlideLanes<FSSE41Ops>(View, Index, Constants);
+	}
+	return VectorNum;
+}
+
+bool IsSlideKernelSSE41Compiled()
+{
+	return true;
+}
+
+#else
+
+int32_t StepSlideBatchSSE41(const FSlideBatchView&, const FSlideKernelConstants&)
+{
+	return 0;
+}
+
+bool IsSlideKernelSSE41Compiled()
+{
+	return false;
+}
+
+#endif
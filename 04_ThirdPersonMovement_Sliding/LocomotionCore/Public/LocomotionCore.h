@@ -0,0 +1,308 @@
+#pragma once
+
+#include <cstdint>
+#include "LocomotionMath.h"
+#include "LocomotionStance.h"
+
+/**
+ * Engine-agnostic locomotion rules (slide, jump buffer, double jump and stance changes).
+ * APlayerCharacter owns an FLocomotionState, gathers world data into FLocomotionTickInput
+ * and applies whatever FLocomotionTickOutput / FLocomotionStanceChange asks for.
+ * No Unreal headers are included so the rules can be built and profiled on their own.
+ */
+
+// Tuning values, filled from the character's editable properties
+struct FLocomotionSettings
+{
+	// Movement
+	float WalkSpeed = 300.f;
+	float SprintSpeed = 600.f;
+
+	// Jumping
+	float JumpBufferTime = 0.1f;
+	bool bAllowDoubleJump = true;
+
+	// Crouch
+	float CrouchSpeed = 200.f;
+	float CrouchCapsuleHalfHeight = 44.f;
+	float StandCapsuleHalfHeight = 88.f;
+	float CustomCapsuleCrouchOffset = -40.f;
+
+	// Sliding
+	float MaxSlideSpeed = 3000.f;
+	float SlideAirThreshold = 500.f;
+	float SlideSpeed = 600.f;
+	float MinSlideSpeed = 200.f;
+	float SlideFriction = 2.25f;
+	float SlideFallGraceTime = 0.5f;
+	float SlideStartGraceTime = 0.2f;
+	float RampBoostSpeed = 1500.f;
+	float FlatSlideBoost = 300.f;
+	// Rate in Hz the uphill penalty factor applies at, other step lengths raise it to StepTime * rate. 0 applies it once per step
+	float UphillPenaltyReferenceRate = 60.f;
+
+	// Fixed slide integration rate in Hz, 0 integrates once per tick with the raw delta time
+	float SlideFixedStepRate = 0.f;
+	int32_t MaxSlideSubsteps = 8;
+	// Without a fixed rate, longer ticks (tick LOD, hitches) are split into equal steps no longer than this
+	float MaxSlideStepTime = 0.05f;
+	// The engine's slide movement mode integrates grounded slides through StepSlideMovement, Tick only runs the airborne grace
+	bool bSlideInMovementMode = false;
+
+	// Prone
+	float ProneCapsuleHalfHeight = 40.f;
+	float ProneSpeed = 125.f;
+	float CustomCapsuleProneOffset = -20.f;
+};
+
+// Per-character state the rules read and write. Everything a tick touches per character fits in one cache line,
+// so the batched pass reads one line per character and the tuning comes from one shared FLocomotionSettings
+struct alignas(64) FLocomotionState
+{
+	ELocomotionStance Stance = ELocomotionStance::Standing;
+	ELocomotionJumpPhase JumpPhase = ELocomotionJumpPhase::None;
+
+	// Run input held, valid in every stance (sliding needs it)
+	bool bIsRunning = false;
+
+	bool bJumpInputQueued = false;
+	bool bJumpPending = false;
+	int32_t JumpCount = 0;
+	// Absolute time the queued jump expires, compared against FLocomotionTickInput::Time
+	double JumpBufferDeadline = 0.0;
+
+	FLocomotionVector SlideVelocity;
+	float SlideFallTimer = 0.f;
+	float SlideStartTimer = 0.f;
+	float SlideStepAccumulator = 0.f;
+
+	FLocomotionVector2D MovementInput;
+
+	bool IsDancing() const { return Stance == ELocomotionStance::Dancing; }
+	bool IsSliding() const { return Stance == ELocomotionStance::Sliding; }
+	bool IsProning() const { return LocomotionStance::GetInfo(Stance).Parent == ELocomotionStance::Proning; }
+	// Prone counts as crouched, as the character has to crouch before going prone
+	bool IsCrouching() const { return IsProning() || LocomotionStance::GetInfo(Stance).Parent == ELocomotionStance::Crouching; }
+	bool IsInProneTransition() const { return LocomotionStance::GetInfo(Stance).bInProneTransition; }
+	bool IsJumping() const { return LocomotionStance::HasFlag(JumpPhase, ELocomotionJumpPhase::Jumping); }
+	bool IsFlipping() const { return LocomotionStance::HasFlag(JumpPhase, ELocomotionJumpPhase::Flipping); }
+};
+
+static_assert(sizeof(FLocomotionState) == 64, "FLocomotionState should stay within one cache line");
+
+// World data gathered by the engine before a tick
+struct FLocomotionTickInput
+{
+	float DeltaTime = 0.f;
+	// Game time in seconds, deadlines in FLocomotionState are absolute on this clock
+	double Time = 0.0;
+	bool bIsGrounded = false;
+	bool bIsFalling = false;
+	FLocomotionVector ActorForward = FLocomotionVector(1.f, 0.f, 0.f);
+
+	// Movement component velocity and acceleration, only read by IsIdle
+	FLocomotionVector Velocity;
+	FLocomotionVector Acceleration;
+
+	// Result of the downward slide probe, only read while sliding
+	bool bHasSlideGroundHit = false;
+	FLocomotionVector SlideGroundNormal = FLocomotionVector::Up();
+};
+
+// Requests the engine has to apply after a tick
+struct FLocomotionTickOutput
+{
+	bool bSetMaxWalkSpeed = false;
+	float MaxWalkSpeed = 0.f;
+
+	bool bApplySlideMovement = false;
+	FLocomotionVector SlideMoveDirection;
+	float SlideMoveScale = 0.f;
+
+	bool bExitSlide = false;
+
+	// Slope the slide reacted to this tick, for debug display only
+	bool bHasSlideSlope = false;
+	float SlideSlopeAngle = 0.f;
+	float SlideAlignment = 0.f;
+	bool bRampBoostApplied = false;
+	bool bUphillPenaltyApplied = false;
+};
+
+// Capsule / actor changes for a stance switch
+struct FLocomotionStanceChange
+{
+	bool bApply = false;
+	float CapsuleHalfHeight = 0.f;
+	float MeshOffsetZ = 0.f;
+	bool bSetMaxWalkSpeed = false;
+	float MaxWalkSpeed = 0.f;
+
+	// Optional actor offsets, in order before resizing the capsule. ResolveStanceOffsetZ folds them into one move
+	float PreOffsetZ = 0.f;
+	float OffsetZ = 0.f;
+};
+
+enum class ELocomotionClearance : uint8_t
+{
+	ProneOnly,
+	Crouch,
+	Stand
+};
+
+/**
+ * Headroom above a character from one upward sphere sweep: the height above the actor location the top of the
+ * capsule can reach. Answers the stand and crouch checks together.
+ */
+struct FLocomotionClearance
+{
+	float Headroom = 0.f;
+	ELocomotionClearance Clearance = ELocomotionClearance::ProneOnly;
+
+	bool CanStand() const { return Clearance == ELocomotionClearance::Stand; }
+	bool CanCrouch() const { return Clearance != ELocomotionClearance::ProneOnly; }
+};
+
+// Clearance sweep from the top of the current capsule up to the standing height, sphere center heights above the actor location
+struct FLocomotionClearanceSweep
+{
+	float StartHeight = 0.f;
+	float EndHeight = 0.f;
+	float Radius = 0.f;
+};
+
+// Button and anim notify events the rules react to between ticks
+enum class ELocomotionEvent : uint8_t
+{
+	Move,
+	RunPressed,
+	RunReleased,
+	Dance,
+	Jump,
+	CrouchPressed,
+	CrouchReleased,
+	Prone,
+	ApplyJumpForce,
+	TriggerFlip,
+	EndFlip,
+	StartProneTransition,
+	EndProneTransition
+};
+
+// World answers an event reads. Ground and clearance are only valid for the Queries bits set, see GetEventQueries
+struct FLocomotionEventContext
+{
+	double Time = 0.0;
+	bool bIsGrounded = false;
+	bool bIsFalling = false;
+	bool bHasController = true;
+	FLocomotionVector ActorForward = FLocomotionVector(1.f, 0.f, 0.f);
+	float CapsuleHalfHeight = 0.f;
+
+	// Move only
+	FLocomotionVector2D MoveInput;
+
+	uint8_t Queries = 0;
+	float GroundSpeed = 0.f;
+	float GroundDistance = 0.f;
+	bool bCanStand = true;
+	bool bCanCrouch = true;
+
+	static constexpr uint8_t QueryGround = 1;
+	static constexpr uint8_t QueryClearance = 2;
+};
+
+// What the engine applies after an event
+struct FLocomotionEventResult
+{
+	// Move only: false when the input should not drive movement
+	bool bAcceptedMove = false;
+	bool bSetMaxWalkSpeed = false;
+	float MaxWalkSpeed = 0.f;
+	FLocomotionStanceChange StanceChange;
+};
+
+namespace Locomotion
+{
+	// Moves to the stance the transition table gives for Event. Returns false and leaves State alone when the event is not allowed
+	bool ApplyStanceEvent(FLocomotionState& State, ELocomotionStanceEvent Event);
+
+	// Capsule, mesh offset and max speed of a stance, from the stance table
+	FLocomotionStanceChange MakeStanceChange(const FLocomotionSettings& Settings, ELocomotionStance Stance);
+
+	// Per-frame state update, the body of APlayerCharacter::Tick
+	void Tick(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, FLocomotionTickOutput& Output);
+
+	// True when Tick would leave State unchanged until an input, anim notify or movement mode change arrives,
+	// so the character can stop ticking. A moving or accelerating character is never idle. Checked with the input of the tick that just ran
+	bool IsIdle(const FLocomotionState& State, const FLocomotionTickInput& Input);
+
+	// True when Tick will read the slide ground probe this frame
+	bool NeedsSlideGroundProbe(const FLocomotionState& State, const FLocomotionSettings& Settings);
+
+	// One grounded slide update over Input.DeltaTime, fixed or variable step as Settings asks. Tick runs it unless
+	// Settings.bSlideInMovementMode hands it to the movement mode. Returns false when the slide should end
+	bool StepSlideMovement(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionTickInput& Input, FLocomotionTickOutput& Output, float& OutSlideSpeed);
+
+	// Stores the move input and returns false when it should not drive movement
+	bool AcceptMoveInput(FLocomotionState& State, float InputX, float InputY, bool bHasController);
+
+	// Max walk speed for the current stance. Returns false while sliding (slide owns the speed)
+	bool ResolveMaxWalkSpeed(const FLocomotionState& State, const FLocomotionSettings& Settings, float ForwardInput, float& OutMaxWalkSpeed);
+
+	// Run input. Returns true when OutMaxWalkSpeed should be applied
+	bool SetRunning(FLocomotionState& State, const FLocomotionSettings& Settings, bool bRunning, float& OutMaxWalkSpeed);
+
+	// One button or anim notify event, for APlayerCharacter and LocomotionRollback::SimulateFrame alike
+	FLocomotionEventResult HandleEvent(FLocomotionState& State, const FLocomotionSettings& Settings, ELocomotionEvent Event, const FLocomotionEventContext& Context);
+
+	// FLocomotionEventContext::Query bits HandleEvent reads for Event in State, so the engine only traces and sweeps when it has to
+	uint8_t GetEventQueries(const FLocomotionState& State, ELocomotionEvent Event);
+
+	void StartDance(FLocomotionState& State);
+
+	// Jump input and anim notify events
+	void QueueJumpInput(FLocomotionState& State, const FLocomotionSettings& Settings, double Time);
+	void ApplyJumpForce(FLocomotionState& State);
+	void TriggerFlip(FLocomotionState& State);
+	void EndFlip(FLocomotionState& State);
+	void StartProneTransition(FLocomotionState& State);
+	void EndProneTransition(FLocomotionState& State);
+
+	// Crouch / slide press gating
+	bool CanHandleCrouchOrSlidePress(const FLocomotionState& State);
+	bool WantsSlideFromCrouchPress(const FLocomotionState& State, const FLocomotionSettings& Settings, bool bIsGrounded, float GroundDistance);
+
+	// Slide start. GroundDistance is only read when not grounded
+	bool CanStartSlide(const FLocomotionState& State, const FLocomotionSettings& Settings, float CurrentSpeed, bool bIsGrounded, float GroundDistance);
+	FLocomotionStanceChange StartSlide(FLocomotionState& State, const FLocomotionSettings& Settings, const FLocomotionVector& ActorForward);
+
+	// Moves to the stance a client reports. Returns no change and keeps State when it already is in Stance or one of
+	// its sub-states, when no single transition reaches Stance, or when a taller capsule does not fit the clearance
+	FLocomotionStanceChange ForceStance(FLocomotionState& State, const FLocomotionSettings& Settings, ELocomotionStance Stance, const FLocomotionVector& ActorForward, bool bCanStand, bool bCanCrouch);
+
+	// Takes the stance the server reports without validation. Returns no change when already in Stance or one of its sub-states
+	FLocomotionStanceChange AdoptStance(FLocomotionState& State, const FLocomotionSettings& Settings, ELocomotionStance Stance, const FLocomotionVector& ActorForward);
+
+	// Leaves the slide in the tallest stance the clearance allows
+	FLocomotionStanceChange ExitSlide(FLocomotionState& State, const FLocomotionSettings& Settings, bool bCanStand, bool bCanCrouch);
+
+	// Stand <-> crouch toggle. bCanStand is only read when currently crouching
+	FLocomotionStanceChange ToggleCrouch(FLocomotionState& State, const FLocomotionSettings& Settings, bool bCanStand);
+
+	// Crouch <-> prone toggle
+	bool CanToggleProne(const FLocomotionState& State, bool bIsFalling);
+	FLocomotionStanceChange ToggleProne(FLocomotionState& State, const FLocomotionSettings& Settings, float CurrentCapsuleHalfHeight, bool bCanCrouchUp);
+
+	// Clearance sweep for a capsule of CurrentHalfHeight and Radius
+	FLocomotionClearanceSweep MakeClearanceSweep(const FLocomotionSettings& Settings, float CurrentHalfHeight, float Radius);
+
+	// Classifies the sweep result. A sweep that starts inside geometry leaves no headroom. Crouching needs the whole
+	// crouch capsule, standing tolerates a ceiling up to CeilingCheckOffset below the standing capsule top
+	FLocomotionClearance ResolveClearance(const FLocomotionSettings& Settings, const FLocomotionClearanceSweep& Sweep, float CeilingCheckOffset,
+		bool bHit, bool bStartPenetrating, float HitDistance);
+
+	// Net actor offset of Change, each step stopped by the free space below and above the current capsule the way a sweep would be.
+	// A negative gap is unknown and leaves that direction open
+	float ResolveStanceOffsetZ(const FLocomotionStanceChange& Change, float FloorGap, float CeilingGap);
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Minimal vector math used by the locomotion core.
+ * Mirrors the FVector / FMath behaviour the Unreal character relies on, without any engine headers.
+ */
+
+namespace LocomotionMath
+{
+	constexpr float SmallNumber = 1.e-8f;
+	constexpr float KindaSmallNumber = 1.e-4f;
+	constexpr float Pi = 3.14159265358979323846f;
+	constexpr float MaxFloat = 3.402823466e+38f;
+
+	inline float Clamp(float Value, float Min, float Max)
+	{
+		return Value < Min ? Min : (Value < Max ? Value : Max);
+	}
+
+	inline float RadiansToDegrees(float Radians)
+	{
+		return Radians * (180.f / Pi);
+	}
+
+	// Polynomial acos (Abramowitz & Stegun 4.4.46, |error| <= 2e-8 rad).
+	// Used instead of std::acos so the scalar and SIMD slide paths produce identical bits on every platform.
+	constexpr float AcosCoefficients[8] = { 1.5707963050f, -0.2145988016f, 0.0889789874f, -0.0501743046f, 0.0308918810f, -0.0170881256f, 0.0066700901f, -0.0012624911f };
+
+	inline float Acos(float Value)
+	{
+		const float X = Clamp(Value, -1.f, 1.f);
+		const float AbsX = X < 0.f ? -X : X;
+
+		float Poly = AcosCoefficients[7];
+		for (int Index = 6; Index >= 0; --Index)
+		{
+			Poly = Poly * AbsX + AcosCoefficients[Index];
+		}
+
+		const float Result = std::sqrt(1.f - AbsX) * Poly;
+		return X < 0.f ? Pi - Result : Result;
+	}
+}
+
+struct FLocomotionVector
+{
+	float X = 0.f;
+	float Y = 0.f;
+	float Z = 0.f;
+
+	constexpr FLocomotionVector() = default;
+	constexpr FLocomotionVector(float InX, float InY, float InZ) : X(InX), Y(InY), Z(InZ) {}
+
+	static constexpr FLocomotionVector Zero() { return FLocomotionVector(0.f, 0.f, 0.f); }
+	static constexpr FLocomotionVector Up() { return FLocomotionVector(0.f, 0.f, 1.f); }
+
+	FLocomotionVector operator+(const FLocomotionVector& Other) const { return FLocomotionVector(X + Other.X, Y + Other.Y, Z + Other.Z); }
+	FLocomotionVector operator-(const FLocomotionVector& Other) const { return FLocomotionVector(X - Other.X, Y - Other.Y, Z - Other.Z); }
+	FLocomotionVector operator*(float Scale) const { return FLocomotionVector(X * Scale, Y * Scale, Z * Scale); }
+	FLocomotionVector& operator+=(const FLocomotionVector& Other) { X += Other.X; Y += Other.Y; Z += Other.Z; return *this; }
+	FLocomotionVector& operator*=(float Scale) { X *= Scale; Y *= Scale; Z *= Scale; return *this; }
+
+	float SizeSquared() const { return X * X + Y * Y + Z * Z; }
+	float Size() const { return std::sqrt(SizeSquared()); }
+
+	static float DotProduct(const FLocomotionVector& A, const FLocomotionVector& B)
+	{
+		return A.X * B.X + A.Y * B.Y + A.Z * B.Z;
+	}
+
+	static FLocomotionVector CrossProduct(const FLocomotionVector& A, const FLocomotionVector& B)
+	{
+		return FLocomotionVector(A.Y * B.Z - A.Z * B.Y, A.Z * B.X - A.X * B.Z, A.X * B.Y - A.Y * B.X);
+	}
+
+	// Same contract as FVector::GetSafeNormal
+	FLocomotionVector GetSafeNormal(float Tolerance = LocomotionMath::SmallNumber) const
+	{
+		const float SquareSum = SizeSquared();
+		if (SquareSum == 1.f)
+		{
+			return *this;
+		}
+		if (SquareSum < Tolerance)
+		{
+			return Zero();
+		}
+		return *this * (1.f / std::sqrt(SquareSum));
+	}
+
+	// Same contract as FVector::GetClampedToMaxSize
+	FLocomotionVector GetClampedToMaxSize(float MaxSize) const
+	{
+		if (MaxSize < LocomotionMath::KindaSmallNumber)
+		{
+			return Zero();
+		}
+		const float VSq = SizeSquared();
+		if (VSq > MaxSize * MaxSize)
+		{
+			return *this * (MaxSize / std::sqrt(VSq));
+		}
+		return *this;
+	}
+};
+
+struct FLocomotionVector2D
+{
+	float X = 0.f;
+	float Y = 0.f;
+
+	float Size() const { return std::sqrt(X * X + Y * Y); }
+};
+
+namespace LocomotionMath
+{
+	// Same contract as FMath::VInterpTo
+	inline FLocomotionVector VInterpTo(const FLocomotionVector& Current, const FLocomotionVector& Target, float DeltaTime, float InterpSpeed)
+	{
+		if (InterpSpeed <= 0.f)
+		{
+			return Target;
+		}
+
+		const FLocomotionVector Dist = Target - Current;
+		if (Dist.SizeSquared() < KindaSmallNumber)
+		{
+			return Target;
+		}
+
+		return Current + Dist * Clamp(DeltaTime * InterpSpeed, 0.f, 1.f);
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+#include "LocomotionCore.h"
+
+/**
+ * Rollback support for the locomotion rules.
+ * FLocomotionSnapshot is the whole FLocomotionState plus the capsule height in 48 trivially copyable bytes.
+ * FLocomotionRollbackBuffer keeps one snapshot and the input of every recent frame, so a late or corrected
+ * input can be written into a past frame and the frames after it resimulated from the buffered inputs.
+ */
+
+struct FLocomotionSnapshot
+{
+	// Absolute on the FLocomotionTickInput::Time clock, kept as a double so a restore is exact
+	double JumpBufferDeadline = 0.0;
+
+	FLocomotionVector SlideVelocity;
+	FLocomotionVector2D MovementInput;
+	float SlideFallTimer = 0.f;
+	float SlideStartTimer = 0.f;
+	float SlideStepAccumulator = 0.f;
+	float CapsuleHalfHeight = 0.f;
+
+	ELocomotionStance Stance = ELocomotionStance::Standing;
+	ELocomotionJumpPhase JumpPhase = ELocomotionJumpPhase::None;
+	// FlagRunning | FlagJumpQueued | FlagJumpPending
+	uint8_t Flags = 0;
+	uint8_t JumpCount = 0;
+
+	static constexpr uint8_t FlagRunning = 1;
+	static constexpr uint8_t FlagJumpQueued = 2;
+	static constexpr uint8_t FlagJumpPending = 4;
+};
+
+static_assert(std::is_trivially_copyable<FLocomotionSnapshot>::value, "Snapshots are copied as raw bytes");
+static_assert(sizeof(FLocomotionSnapshot) == 48, "Keep the snapshot at 48 bytes");
+
+// Everything one frame of the rules consumes, buffered so the frame can be replayed
+struct FLocomotionFrameInput
+{
+	FLocomotionTickInput Tick;
+
+	// A Move event with MovementInput. Frames without one keep the last move input, like the character does
+	bool bMoveInput = false;
+	FLocomotionVector2D MovementInput;
+	bool bRunHeld = false;
+	bool bDancePressed = false;
+	bool bJumpPressed = false;
+	bool bCrouchPressed = false;
+	bool bCrouchReleased = false;
+	bool bPronePressed = false;
+
+	// Anim notify events the frame delivered, applied after the input in bit order
+	uint8_t Notifies = 0;
+
+	// World answers from when the frame first ran. Replays reuse them instead of tracing again
+	float GroundSpeed = 0.f;
+	float GroundDistance = 0.f;
+	bool bCanStand = true;
+	bool bCanCrouch = true;
+
+	static constexpr uint8_t NotifyApplyJumpForce = 1;
+	static constexpr uint8_t NotifyTriggerFlip = 2;
+	static constexpr uint8_t NotifyEndFlip = 4;
+	static constexpr uint8_t NotifyStartProneTransition = 8;
+	static constexpr uint8_t NotifyEndProneTransition = 16;
+};
+
+namespace LocomotionRollback
+{
+	FLocomotionSnapshot Capture(const FLocomotionState& State, float CapsuleHalfHeight);
+	void Restore(const FLocomotionSnapshot& Snapshot, FLocomotionState& State, float& OutCapsuleHalfHeight);
+
+	// Adds an event handled live to the frame's input, with the world answers it queried
+	void RecordEvent(FLocomotionFrameInput& Input, ELocomotionEvent Event, const FLocomotionEventContext& Context);
+
+	// One frame the way APlayerCharacter runs it: move, run, dance, jump, crouch/slide and prone input, anim notifies, each through
+	// Locomotion::HandleEvent, then Tick and the slide exit. CapsuleHalfHeight follows the stance changes
+	void SimulateFrame(FLocomotionState& State, float& CapsuleHalfHeight, const FLocomotionSettings& Settings, const FLocomotionFrameInput& Input, FLocomotionTickOutput& Output);
+}
+
+class FLocomotionRollbackBuffer
+{
+public:
+	// About one second at 60 Hz
+	static constexpr int32_t Capacity = 64;
+
+	// Stores the state at the start of Frame and the input the frame runs with, overwriting the frame Capacity before it
+	void Record(uint32_t Frame, const FLocomotionSnapshot& Snapshot, const FLocomotionFrameInput& Input);
+
+	bool HasFrame(uint32_t Frame) const;
+	const FLocomotionSnapshot* FindSnapshot(uint32_t Frame) const;
+
+	// Replaces the input of a buffered frame, for example a corrected remote input. Returns false once the frame is gone
+	bool SetInput(uint32_t Frame, const FLocomotionFrameInput& Input);
+
+	// Restores the state at the start of FromFrame and runs the buffered frames up to EndFrame, re-recording each snapshot.
+	// Leaves State at the start of EndFrame and returns the number of frames run, 0 when FromFrame is no longer buffered
+	int32_t Resimulate(uint32_t FromFrame, uint32_t EndFrame, FLocomotionState& State, float& CapsuleHalfHeight, const FLocomotionSettings& Settings);
+
+	void Reset();
+
+private:
+	struct FEntry
+	{
+		FLocomotionSnapshot Snapshot;
+		FLocomotionFrameInput Input;
+		uint32_t Frame = UINT32_MAX;
+	};
+
+	FEntry Entries[Capacity];
+};
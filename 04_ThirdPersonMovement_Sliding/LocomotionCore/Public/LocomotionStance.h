@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+
+struct FLocomotionSettings;
+
+/**
+ * Locomotion stance as one hierarchical state instead of independent flags.
+ * Sub-states share their parent's capsule and speed (Dancing is a Standing sub-state,
+ * the prone transitions are Crouching / Proning sub-states), so combinations such as
+ * crouching while sliding or a prone transition while standing cannot be represented.
+ */
+enum class ELocomotionStance : uint8_t
+{
+	Standing,
+	Dancing,
+	Crouching,
+	CrouchingInProneTransition,
+	Proning,
+	ProningInProneTransition,
+	Sliding,
+	Num
+};
+
+// Events that move between stances, see LocomotionStance::Transitions
+enum class ELocomotionStanceEvent : uint8_t
+{
+	StartDance,
+	StopDance,
+	Crouch,
+	Stand,
+	Prone,
+	CrouchFromProne,
+	BeginProneTransition,
+	EndProneTransition,
+	StartSlide,
+	ExitSlideToStand,
+	ExitSlideToCrouch,
+	ExitSlideToProne,
+	Fall,
+	Num
+};
+
+// Jump and flip can overlap (a flip keeps going after the takeoff flag clears), so the phase is two bits
+enum class ELocomotionJumpPhase : uint8_t
+{
+	None = 0,
+	Jumping = 1,
+	Flipping = 2,
+	JumpingAndFlipping = Jumping | Flipping
+};
+
+// Data shared by a stance and its sub-states
+struct FLocomotionStanceInfo
+{
+	ELocomotionStance Parent;
+
+	// Capsule and speed come from the tuning values, mesh relative Z is always -CapsuleHalfHeight
+	float FLocomotionSettings::* CapsuleHalfHeight;
+	float FLocomotionSettings::* MaxSpeed;
+
+	// Tick runs the slide and jump rules (crouched stances only react to falling)
+	bool bRunsJumpRules;
+	// Sprint replaces MaxSpeed while running forward
+	bool bCanSprint;
+	// Slide owns the max walk speed, move input must not override it
+	bool bOwnsMaxSpeed;
+	bool bCanQueueJump;
+	bool bBlocksMoveInput;
+	bool bInProneTransition;
+};
+
+namespace LocomotionStance
+{
+	constexpr int32_t NumStances = static_cast<int32_t>(ELocomotionStance::Num);
+	constexpr int32_t NumEvents = static_cast<int32_t>(ELocomotionStanceEvent::Num);
+
+	// Marks an event that is not allowed from a stance
+	constexpr ELocomotionStance Invalid = ELocomotionStance::Num;
+
+	extern const FLocomotionStanceInfo Infos[NumStances];
+
+	inline const FLocomotionStanceInfo& GetInfo(ELocomotionStance Stance)
+	{
+		return Infos[static_cast<int32_t>(Stance)];
+	}
+
+	constexpr ELocomotionStance S = ELocomotionStance::Standing;
+	constexpr ELocomotionStance D = ELocomotionStance::Dancing;
+	constexpr ELocomotionStance C = ELocomotionStance::Crouching;
+	constexpr ELocomotionStance CT = ELocomotionStance::CrouchingInProneTransition;
+	constexpr ELocomotionStance P = ELocomotionStance::Proning;
+	constexpr ELocomotionStance PT = ELocomotionStance::ProningInProneTransition;
+	constexpr ELocomotionStance SL = ELocomotionStance::Sliding;
+	constexpr ELocomotionStance X = Invalid;
+
+	// Next stance per [stance][event]
+	constexpr ELocomotionStance Transitions[NumStances][NumEvents] =
+	{
+		//            StartDance StopDance Crouch Stand Prone CrouchFromProne BeginPT EndPT StartSlide ToStand ToCrouch ToProne Fall
+		/* S  */    { D,         X,        C,     X,    X,    X,              X,      X,    SL,        X,      X,       X,      S  },
+		/* D  */    { D,         S,        C,     X,    X,    X,              X,      X,    SL,        X,      X,       X,      D  },
+		/* C  */    { X,         X,        X,     S,    PT,   X,              CT,     C,    X,         X,      X,       X,      C  },
+		/* CT */    { X,         X,        X,     X,    X,    X,              CT,     C,    X,         X,      X,       X,      CT },
+		/* P  */    { X,         X,        X,     X,    X,    CT,             PT,     P,    X,         X,      X,       X,      C  },
+		/* PT */    { X,         X,        X,     X,    X,    X,              PT,     P,    X,         X,      X,       X,      CT },
+		/* SL */    { X,         X,        C,     X,    X,    X,              X,      X,    X,         S,      C,       P,      SL },
+	};
+
+	constexpr ELocomotionStance Next(ELocomotionStance Stance, ELocomotionStanceEvent Event)
+	{
+		return Transitions[static_cast<int32_t>(Stance)][static_cast<int32_t>(Event)];
+	}
+
+	// True when one event takes From to To or one of its sub-states, for stance changes reported by a client
+	bool CanReach(ELocomotionStance From, ELocomotionStance To);
+
+	static_assert(Next(C, ELocomotionStanceEvent::StartSlide) == Invalid, "Crouching cannot start a slide");
+	static_assert(Next(SL, ELocomotionStanceEvent::StartSlide) == Invalid, "Sliding cannot restart a slide");
+	static_assert(Next(S, ELocomotionStanceEvent::BeginProneTransition) == Invalid, "Prone transitions only play while crouched or prone");
+	static_assert(Next(P, ELocomotionStanceEvent::Fall) == C, "Falling while prone drops back to crouch");
+
+	inline bool HasFlag(ELocomotionJumpPhase Phase, ELocomotionJumpPhase Flag)
+	{
+		return (static_cast<uint8_t>(Phase) & static_cast<uint8_t>(Flag)) != 0;
+	}
+
+	inline ELocomotionJumpPhase SetFlag(ELocomotionJumpPhase Phase, ELocomotionJumpPhase Flag, bool bSet)
+	{
+		const uint8_t Bits = bSet ? static_cast<uint8_t>(Phase) | static_cast<uint8_t>(Flag) : static_cast<uint8_t>(Phase) & ~static_cast<uint8_t>(Flag);
+		return static_cast<ELocomotionJumpPhase>(Bits);
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "LocomotionCore.h"
+
+/**
+ * Batched slide dynamics for large crowds.
+ * Runs the slide block of Locomotion::Tick (slope boost, uphill penalty, flat boost interp,
+ * speed clamp, friction, slide timers and the exit test) over structure-of-arrays state in one pass.
+ * The SSE4.1 and AVX2 paths share the scalar path's operation order, so every path produces
+ * bit-identical results, and the scalar path matches Locomotion::Tick bit for bit, long ticks included.
+ */
+
+enum class ESlideKernelPath : uint8_t
+{
+	Auto,
+	Scalar,
+	SSE41,
+	AVX2
+};
+
+struct FSlideBatch
+{
+	// Slide state, read and written by the kernel
+	std::vector<float> VelocityX;
+	std::vector<float> VelocityY;
+	std::vector<float> VelocityZ;
+	std::vector<float> FallTimer;
+	std::vector<float> StartTimer;
+
+	// Per-frame inputs
+	std::vector<float> GroundNormalX;
+	std::vector<float> GroundNormalY;
+	std::vector<float> GroundNormalZ;
+	std::vector<float> ForwardX;
+	std::vector<float> ForwardY;
+	std::vector<float> ForwardZ;
+	std::vector<uint8_t> HasGroundHit;
+	std::vector<uint8_t> IsGrounded;
+	std::vector<uint8_t> IsRunning;
+
+	// Outputs
+	std::vector<float> MoveDirectionX;
+	std::vector<float> MoveDirectionY;
+	std::vector<float> MoveDirectionZ;
+	std::vector<float> MoveScale;
+	std::vector<uint8_t> ExitSlide;
+
+	void Resize(int32_t NewNum);
+	int32_t Num() const { return static_cast<int32_t>(VelocityX.size()); }
+
+	// AoS <-> SoA helpers for characters that tick through Locomotion::Tick elsewhere
+	void LoadLane(int32_t Index, const FLocomotionState& State, const FLocomotionTickInput& Input);
+	void StoreLane(int32_t Index, const FLocomotionSettings& Settings, FLocomotionState& State, FLocomotionTickOutput& Output) const;
+};
+
+namespace SlideKernel
+{
+	// True when the path was compiled in and the CPU supports it
+	bool IsPathSupported(ESlideKernelPath Path);
+
+	// Picks the widest supported path for Auto, falls back to Scalar for unsupported requests
+	ESlideKernelPath ResolvePath(ESlideKernelPath Path);
+
+	const char* GetPathName(ESlideKernelPath Path);
+
+	// Advances every lane of the batch by DeltaTime. All lanes are assumed to be sliding.
+	// Without a fixed slide step rate, a DeltaTime longer than MaxSlideStepTime is split into equal steps like Locomotion::Tick,
+	// and a lane that exits keeps its exit step's results. With a fixed rate this is one step, call it once per substep
+	void Step(FSlideBatch& Batch, const FLocomotionSettings& Settings, float DeltaTime, ESlideKernelPath Path = ESlideKernelPath::Auto);
+}
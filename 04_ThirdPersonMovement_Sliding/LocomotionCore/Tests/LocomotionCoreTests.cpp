@@ -0,0 +1,364 @@
+// Checks for the locomotion core rules that have no engine dependency.
+// Registered with ctest, exits with code 1 when any check fails.
+
+#include "LocomotionCore.h"
+#include "LocomotionRollback.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	int GFailures = 0;
+
+	void Check(bool bCondition, const char* Name)
+	{
+		if (!bCondition)
+		{
+			std::printf("FAILED: %s\n", Name);
+			++GFailures;
+		}
+	}
+
+	// Clearance under a flat ceiling CeilingHeight above the actor location, swept the way APlayerCharacter::QueryClearance does
+	FLocomotionClearance ClearanceUnderCeiling(const FLocomotionSettings& Settings, float CurrentHalfHeight, float Radius, float CeilingHeight, float CeilingCheckOffset)
+	{
+		const FLocomotionClearanceSweep Sweep = Locomotion::MakeClearanceSweep(Settings, CurrentHalfHeight, Radius);
+		const bool bStartPenetrating = CeilingHeight < Sweep.StartHeight + Radius;
+		const bool bHit = bStartPenetrating || CeilingHeight < Sweep.EndHeight + Radius;
+		const float HitDistance = bHit && !bStartPenetrating ? CeilingHeight - Radius - Sweep.StartHeight : 0.f;
+		return Locomotion::ResolveClearance(Settings, Sweep, CeilingCheckOffset, bHit, bStartPenetrating, HitDistance);
+	}
+
+	void TestClearance()
+	{
+		const FLocomotionSettings Settings;
+		const float Radius = 34.f;
+		const float CeilingCheckOffset = 5.f;
+		const float Prone = Settings.ProneCapsuleHalfHeight;
+		const float Crouch = Settings.CrouchCapsuleHalfHeight;
+
+		// Between the prone and crouch capsule tops only prone fits
+		const FLocomotionClearance BetweenProneAndCrouch = ClearanceUnderCeiling(Settings, Prone, Radius, (Prone + Crouch) * 0.5f, CeilingCheckOffset);
+		Check(!BetweenProneAndCrouch.CanCrouch(), "ceiling between prone and crouch heights blocks crouching");
+		Check(!BetweenProneAndCrouch.CanStand(), "ceiling between prone and crouch heights blocks standing");
+
+		// A sweep that starts inside geometry has no headroom
+		const FLocomotionClearance Penetrating = ClearanceUnderCeiling(Settings, Prone, Radius, Prone - 1.f, CeilingCheckOffset);
+		Check(Penetrating.Headroom == 0.f && !Penetrating.CanCrouch(), "start penetrating sweep reports no headroom");
+
+		// A slide ends crouched, a lower ceiling has to push it to prone
+		const FLocomotionClearance SlideUnderLowCeiling = ClearanceUnderCeiling(Settings, Crouch, Radius, Crouch - 2.f, CeilingCheckOffset);
+		Check(!SlideUnderLowCeiling.CanCrouch(), "crouched capsule inside a low ceiling falls back to prone");
+
+		const FLocomotionClearance CrouchOnly = ClearanceUnderCeiling(Settings, Prone, Radius, 60.f, CeilingCheckOffset);
+		Check(CrouchOnly.CanCrouch() && !CrouchOnly.CanStand(), "ceiling between crouch and stand heights allows crouching only");
+
+		const FLocomotionClearance WithinTolerance = ClearanceUnderCeiling(Settings, Crouch, Radius, Settings.StandCapsuleHalfHeight - CeilingCheckOffset + 1.f, CeilingCheckOffset);
+		Check(WithinTolerance.CanStand(), "ceiling within CeilingCheckOffset of the standing top allows standing");
+
+		const FLocomotionClearance Open = ClearanceUnderCeiling(Settings, Prone, Radius, 1000.f, CeilingCheckOffset);
+		Check(Open.CanStand() && Open.Headroom >= Settings.StandCapsuleHalfHeight, "open sky allows standing");
+	}
+
+	void TestForceStance()
+	{
+		const FLocomotionSettings Settings;
+		const FLocomotionVector Forward(0.f, 1.f, 0.f);
+
+		FLocomotionState Proning;
+		Proning.Stance = ELocomotionStance::Proning;
+		Check(!Locomotion::ForceStance(Proning, Settings, ELocomotionStance::Sliding, Forward, true, true).bApply && Proning.IsProning(),
+			"client cannot slide out of prone");
+
+		FLocomotionState Crouching;
+		Crouching.Stance = ELocomotionStance::Crouching;
+		Check(!Locomotion::ForceStance(Crouching, Settings, ELocomotionStance::Standing, Forward, false, true).bApply && Crouching.IsCrouching(),
+			"client cannot stand up under a low ceiling");
+		Check(Locomotion::ForceStance(Crouching, Settings, ELocomotionStance::Standing, Forward, true, true).bApply && Crouching.Stance == ELocomotionStance::Standing,
+			"client stands up with clearance");
+
+		FLocomotionState Standing;
+		Check(Locomotion::ForceStance(Standing, Settings, ELocomotionStance::Crouching, Forward, false, false).bApply && Standing.IsCrouching(),
+			"shrinking the capsule needs no clearance");
+
+		FLocomotionState Corrected;
+		Corrected.Stance = ELocomotionStance::Proning;
+		Check(Locomotion::AdoptStance(Corrected, Settings, ELocomotionStance::Sliding, Forward).bApply && Corrected.IsSliding(),
+			"the server's stance is taken without the transition table");
+	}
+
+	void TestIsIdle()
+	{
+		FLocomotionState Standing;
+		FLocomotionTickInput Input;
+		Input.bIsGrounded = true;
+		Check(Locomotion::IsIdle(Standing, Input), "standing still on the ground is idle");
+
+		FLocomotionTickInput Walking = Input;
+		Walking.Velocity = FLocomotionVector(0.f, 300.f, 0.f);
+		Check(!Locomotion::IsIdle(Standing, Walking), "a walking character is not idle");
+
+		FLocomotionTickInput Starting = Input;
+		Starting.Acceleration = FLocomotionVector(0.f, 2048.f, 0.f);
+		Check(!Locomotion::IsIdle(Standing, Starting), "an accelerating character is not idle");
+	}
+
+	void TestStanceTransitions()
+	{
+		using namespace LocomotionStance;
+
+		bool bTargetsValid = true;
+		bool bFallEverywhere = true;
+		for (int32_t Stance = 0; Stance < NumStances; ++Stance)
+		{
+			for (int32_t Event = 0; Event < NumEvents; ++Event)
+			{
+				const int32_t Target = static_cast<int32_t>(Next(static_cast<ELocomotionStance>(Stance), static_cast<ELocomotionStanceEvent>(Event)));
+				bTargetsValid = bTargetsValid && Target <= NumStances;
+			}
+			bFallEverywhere = bFallEverywhere && Next(static_cast<ELocomotionStance>(Stance), ELocomotionStanceEvent::Fall) != Invalid;
+		}
+		Check(bTargetsValid, "every transition lands on a stance or Invalid");
+		Check(bFallEverywhere, "falling is handled from every stance");
+
+		bool bParentsAreRoots = true;
+		for (int32_t Stance = 0; Stance < NumStances; ++Stance)
+		{
+			const ELocomotionStance Parent = Infos[Stance].Parent;
+			bParentsAreRoots = bParentsAreRoots && GetInfo(Parent).Parent == Parent;
+		}
+		Check(bParentsAreRoots, "sub-states point at a parent that is its own parent");
+
+		Check(Next(D, ELocomotionStanceEvent::StopDance) == S && Next(S, ELocomotionStanceEvent::StopDance) == Invalid, "only a dance can stop dancing");
+		Check(Next(C, ELocomotionStanceEvent::Prone) == PT && Next(PT, ELocomotionStanceEvent::EndProneTransition) == P, "going prone plays the transition first");
+		Check(Next(SL, ELocomotionStanceEvent::ExitSlideToProne) == P && Next(S, ELocomotionStanceEvent::ExitSlideToProne) == Invalid, "only a slide exits a slide");
+
+		Check(CanReach(S, SL) && CanReach(D, SL), "standing and dancing can start a slide");
+		Check(!CanReach(C, SL) && !CanReach(P, SL), "crouching and proning cannot start a slide");
+		Check(CanReach(P, C) && CanReach(P, ELocomotionStance::CrouchingInProneTransition), "proning can crouch up into any crouching sub-state");
+		Check(!CanReach(P, S) && !CanReach(S, P), "standing and proning are never one event apart");
+		Check(CanReach(SL, S) && CanReach(SL, C) && CanReach(SL, P), "a slide can exit to every stance");
+
+		// The rules follow the table, a rejected event leaves the stance alone
+		const FLocomotionSettings Settings;
+		FLocomotionState Standing;
+		Check(Locomotion::ToggleCrouch(Standing, Settings, true).bApply && Standing.IsCrouching(), "crouch press crouches a standing character");
+		Check(!Locomotion::ToggleCrouch(Standing, Settings, false).bApply && Standing.IsCrouching(), "crouch press without headroom stays crouched");
+		Check(!Locomotion::StartSlide(Standing, Settings, FLocomotionVector(1.f, 0.f, 0.f)).bApply && Standing.IsCrouching(), "a crouching character cannot start a slide");
+	}
+
+	// Sliding down a 20 degree ramp, facing downhill, with the slide kept alive
+	void MakeRampSlide(const FLocomotionSettings& Settings, FLocomotionState& State, FLocomotionTickInput& Input)
+	{
+		const float RampAngle = 20.f * LocomotionMath::Pi / 180.f;
+		const FLocomotionVector Forward(-1.f, 0.f, 0.f);
+
+		State = FLocomotionState();
+		State.bIsRunning = true;
+		Locomotion::StartSlide(State, Settings, Forward);
+		State.SlideStartTimer = 1.f;
+
+		Input = FLocomotionTickInput();
+		Input.bIsGrounded = true;
+		Input.ActorForward = Forward;
+		Input.bHasSlideGroundHit = true;
+		Input.SlideGroundNormal = FLocomotionVector(-std::sin(RampAngle), 0.f, std::cos(RampAngle));
+	}
+
+	// The fixed-step accumulator, with a power of two rate so the step times add up exactly
+	void TestSlideFixedStep()
+	{
+		FLocomotionSettings Settings;
+		Settings.SlideFixedStepRate = 64.f;
+		const float Step = 1.f / Settings.SlideFixedStepRate;
+
+		FLocomotionTickOutput Output;
+		float SlideSpeed = 0.f;
+
+		// Less than a step only accumulates
+		FLocomotionState Short;
+		FLocomotionTickInput Input;
+		MakeRampSlide(Settings, Short, Input);
+		const FLocomotionVector StartVelocity = Short.SlideVelocity;
+		Input.DeltaTime = Step * 0.5f;
+		Locomotion::StepSlideMovement(Short, Settings, Input, Output, SlideSpeed);
+		Check(Short.SlideStepAccumulator == Step * 0.5f && std::memcmp(&Short.SlideVelocity, &StartVelocity, sizeof(FLocomotionVector)) == 0,
+			"a tick shorter than a step only fills the accumulator");
+		Locomotion::StepSlideMovement(Short, Settings, Input, Output, SlideSpeed);
+		Check(Short.SlideStepAccumulator == 0.f && std::memcmp(&Short.SlideVelocity, &StartVelocity, sizeof(FLocomotionVector)) != 0, "two half steps integrate one step");
+
+		// One long tick and several short ones run the same steps
+		FLocomotionState Long;
+		FLocomotionState Split;
+		MakeRampSlide(Settings, Long, Input);
+		MakeRampSlide(Settings, Split, Input);
+		Input.DeltaTime = Step * 4.f;
+		Locomotion::StepSlideMovement(Long, Settings, Input, Output, SlideSpeed);
+		Input.DeltaTime = Step;
+		for (int Tick = 0; Tick < 4; ++Tick)
+		{
+			Locomotion::StepSlideMovement(Split, Settings, Input, Output, SlideSpeed);
+		}
+		Check(std::memcmp(&Long, &Split, sizeof(FLocomotionState)) == 0, "one four-step tick matches four one-step ticks bit for bit");
+
+		// Past MaxSlideSubsteps the time is dropped rather than carried into later ticks
+		FLocomotionState Hitch;
+		FLocomotionState Capped;
+		MakeRampSlide(Settings, Hitch, Input);
+		MakeRampSlide(Settings, Capped, Input);
+		Input.DeltaTime = 1.f;
+		Locomotion::StepSlideMovement(Hitch, Settings, Input, Output, SlideSpeed);
+		Input.DeltaTime = Step;
+		for (int Tick = 0; Tick < Settings.MaxSlideSubsteps; ++Tick)
+		{
+			Locomotion::StepSlideMovement(Capped, Settings, Input, Output, SlideSpeed);
+		}
+		Check(Hitch.SlideStepAccumulator < Step, "a hitch leaves less than one step in the accumulator");
+		Check(std::memcmp(&Hitch.SlideVelocity, &Capped.SlideVelocity, sizeof(FLocomotionVector)) == 0, "a hitch runs at most MaxSlideSubsteps steps");
+	}
+
+	// Dance press on a standing character, held without move input, then ended by moving. Replaying the buffer has to agree
+	void TestRollbackDance()
+	{
+		const FLocomotionSettings Settings;
+		const uint32_t NumFrames = 6;
+
+		FLocomotionState State;
+		float CapsuleHalfHeight = Settings.StandCapsuleHalfHeight;
+		FLocomotionRollbackBuffer Buffer;
+		FLocomotionTickOutput Output;
+
+		bool bDancedUntilMove = true;
+		for (uint32_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			FLocomotionFrameInput Input;
+			Input.Tick.DeltaTime = 1.f / 60.f;
+			Input.Tick.Time = Frame * static_cast<double>(Input.Tick.DeltaTime);
+			Input.Tick.bIsGrounded = true;
+			Input.bDancePressed = Frame == 0;
+			Input.bMoveInput = Frame == NumFrames - 1;
+			Input.MovementInput.Y = 1.f;
+
+			Buffer.Record(Frame, LocomotionRollback::Capture(State, CapsuleHalfHeight), Input);
+			LocomotionRollback::SimulateFrame(State, CapsuleHalfHeight, Settings, Input, Output);
+			if (Frame < NumFrames - 1)
+			{
+				bDancedUntilMove = bDancedUntilMove && State.IsDancing();
+			}
+		}
+		Check(bDancedUntilMove, "dance press starts a dance that lasts without move input");
+		Check(State.Stance == ELocomotionStance::Standing, "move input ends the dance");
+
+		const FLocomotionSnapshot Live = LocomotionRollback::Capture(State, CapsuleHalfHeight);
+		const int32_t Replayed = Buffer.Resimulate(0, NumFrames, State, CapsuleHalfHeight, Settings);
+		const FLocomotionSnapshot Resimulated = LocomotionRollback::Capture(State, CapsuleHalfHeight);
+		Check(Replayed == static_cast<int32_t>(NumFrames) && std::memcmp(&Live, &Resimulated, sizeof(FLocomotionSnapshot)) == 0,
+			"resimulating a dance matches the live frames");
+	}
+
+	// Events handled live through HandleEvent and recorded with RecordEvent, the way APlayerCharacter records its frames:
+	// sprint into a slide, release it, then crouch and go prone. Resimulating the recording has to land on the live state
+	void TestRollbackRecordedEvents()
+	{
+		struct FScheduledEvent
+		{
+			uint32_t Frame;
+			ELocomotionEvent Event;
+		};
+		const FScheduledEvent Schedule[] = {
+			{ 0, ELocomotionEvent::RunPressed },
+			{ 5, ELocomotionEvent::CrouchPressed },
+			{ 20, ELocomotionEvent::CrouchReleased },
+			{ 22, ELocomotionEvent::RunReleased },
+			{ 25, ELocomotionEvent::CrouchPressed },
+			{ 28, ELocomotionEvent::Prone },
+			{ 30, ELocomotionEvent::StartProneTransition },
+			{ 35, ELocomotionEvent::EndProneTransition }
+		};
+
+		const FLocomotionSettings Settings;
+		const uint32_t NumFrames = 40;
+
+		FLocomotionState State;
+		float CapsuleHalfHeight = Settings.StandCapsuleHalfHeight;
+		FLocomotionRollbackBuffer Buffer;
+		FLocomotionTickOutput Output;
+		bool bSlid = false;
+
+		for (uint32_t Frame = 0; Frame < NumFrames; ++Frame)
+		{
+			const FLocomotionSnapshot Start = LocomotionRollback::Capture(State, CapsuleHalfHeight);
+
+			FLocomotionFrameInput Input;
+			Input.Tick.DeltaTime = 1.f / 60.f;
+			Input.Tick.Time = Frame * static_cast<double>(Input.Tick.DeltaTime);
+			Input.Tick.bIsGrounded = true;
+			Input.bRunHeld = State.bIsRunning;
+
+			FLocomotionEventContext Context;
+			Context.Time = Input.Tick.Time;
+			Context.bIsGrounded = true;
+			Context.MoveInput.Y = 1.f;
+			Context.GroundSpeed = 600.f;
+
+			const auto HandleLive = [&](ELocomotionEvent Event)
+			{
+				Context.Queries = Locomotion::GetEventQueries(State, Event);
+				Context.CapsuleHalfHeight = CapsuleHalfHeight;
+				const FLocomotionEventResult Result = Locomotion::HandleEvent(State, Settings, Event, Context);
+				if (Result.StanceChange.bApply)
+				{
+					CapsuleHalfHeight = Result.StanceChange.CapsuleHalfHeight;
+				}
+				LocomotionRollback::RecordEvent(Input, Event, Context);
+			};
+
+			HandleLive(ELocomotionEvent::Move);
+			for (const FScheduledEvent& Scheduled : Schedule)
+			{
+				if (Scheduled.Frame == Frame)
+				{
+					HandleLive(Scheduled.Event);
+				}
+			}
+
+			Locomotion::Tick(State, Settings, Input.Tick, Output);
+			if (Output.bExitSlide)
+			{
+				const FLocomotionStanceChange Change = Locomotion::ExitSlide(State, Settings, Input.bCanStand, Input.bCanCrouch);
+				CapsuleHalfHeight = Change.bApply ? Change.CapsuleHalfHeight : CapsuleHalfHeight;
+			}
+			bSlid = bSlid || State.IsSliding();
+
+			Buffer.Record(Frame, Start, Input);
+		}
+		Check(bSlid, "the recorded crouch press starts a slide");
+
+		const FLocomotionSnapshot Live = LocomotionRollback::Capture(State, CapsuleHalfHeight);
+		const int32_t Replayed = Buffer.Resimulate(0, NumFrames, State, CapsuleHalfHeight, Settings);
+		const FLocomotionSnapshot Resimulated = LocomotionRollback::Capture(State, CapsuleHalfHeight);
+		Check(Replayed == static_cast<int32_t>(NumFrames) && std::memcmp(&Live, &Resimulated, sizeof(FLocomotionSnapshot)) == 0,
+			"resimulating recorded events matches the live frames");
+	}
+}
+
+int main()
+{
+	TestClearance();
+	TestForceStance();
+	TestIsIdle();
+	TestStanceTransitions();
+	TestSlideFixedStep();
+	TestRollbackDance();
+	TestRollbackRecordedEvents();
+
+	if (GFailures > 0)
+	{
+		std::printf("%d check(s) failed\n", GFailures);
+		return 1;
+	}
+	std::printf("All locomotion core checks passed\n");
+	return 0;
+}
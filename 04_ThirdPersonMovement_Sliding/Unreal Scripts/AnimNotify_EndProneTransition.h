@@ -1,18 +0,0 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Animation/AnimNotifies/AnimNotify.h"
-#include "AnimNotify_EndProneTransition.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class MECHANICS_TEST_LVN_API UAnimNotify_EndProneTransition : public UAnimNotify
-{
-	GENERATED_BODY()
-public:
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
-};
@@ -1,19 +0,0 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "Animation/AnimNotifies/AnimNotify.h"
-#include "AnimNotify_EndTriggerFlip.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class MECHANICS_TEST_LVN_API UAnimNotify_EndTriggerFlip : public UAnimNotify
-{
-	GENERATED_BODY()
-	
-public:
-	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
-};
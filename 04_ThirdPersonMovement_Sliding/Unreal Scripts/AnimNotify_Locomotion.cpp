@@ -0,0 +1,19 @@
+#include "AnimNotify_Locomotion.h"
+#include "LocomotionSubsystem.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+
+void UAnimNotify_Locomotion::Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation)
+{
+	// Editor previews have no subsystem, so nothing is queued there
+	const UWorld* World = MeshComp ? MeshComp->GetWorld() : nullptr;
+	if (ULocomotionSubsystem* Subsystem = World ? World->GetSubsystem<ULocomotionSubsystem>() : nullptr)
+	{
+		Subsystem->QueueNotify(MeshComp, Event);
+	}
+}
+
+FString UAnimNotify_Locomotion::GetNotifyName_Implementation() const
+{
+	return StaticEnum<ELocomotionNotifyEvent>()->GetNameStringByValue(static_cast<int64>(Event));
+}
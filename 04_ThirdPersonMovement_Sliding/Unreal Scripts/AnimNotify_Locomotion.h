@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNotifies/AnimNotify.h"
+#include "LocomotionNotifyReceiver.h"
+#include "AnimNotify_Locomotion.generated.h"
+
+/**
+ * One notify for every locomotion animation event. The event is queued on ULocomotionSubsystem
+ * for the receiver registered with the mesh, new events only need a new ELocomotionNotifyEvent value.
+ */
+UCLASS(meta = (DisplayName = "Locomotion Event"))
+class MECHANICS_TEST_LVN_API UAnimNotify_Locomotion : public UAnimNotify
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Notify(USkeletalMeshComponent* MeshComp, UAnimSequenceBase* Animation) override;
+	virtual FString GetNotifyName_Implementation() const override;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion")
+	ELocomotionNotifyEvent Event = ELocomotionNotifyEvent::ApplyJumpForce;
+};
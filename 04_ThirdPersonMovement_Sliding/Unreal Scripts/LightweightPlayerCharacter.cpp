@@ -0,0 +1,84 @@
+#include "LightweightPlayerCharacter.h"
+#include "LocomotionSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	struct FVariantCost
+	{
+		double SpawnMs = 0.0;
+		double MemoryKB = 0.0;
+		int32 Components = 0;
+	};
+
+	// Spawns Count characters away from the level, measures, then destroys them
+	FVariantCost MeasureVariant(UWorld* World, TSubclassOf<APlayerCharacter> CharacterClass, int32 Count)
+	{
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		TArray<APlayerCharacter*> Spawned;
+		Spawned.Reserve(Count);
+
+		const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+		const double StartSeconds = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const FVector Location(Index * 200.f, 0.f, 50000.f);
+			if (APlayerCharacter* Character = World->SpawnActor<APlayerCharacter>(CharacterClass, Location, FRotator::ZeroRotator, Params))
+			{
+				Spawned.Add(Character);
+			}
+		}
+		const double EndSeconds = FPlatformTime::Seconds();
+		const uint64 UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+		FVariantCost Cost;
+		if (Spawned.Num() > 0)
+		{
+			Cost.SpawnMs = (EndSeconds - StartSeconds) * 1000.0 / Spawned.Num();
+			Cost.MemoryKB = UsedPhysicalAfter > UsedPhysicalBefore ? (UsedPhysicalAfter - UsedPhysicalBefore) / 1024.0 / Spawned.Num() : 0.0;
+			Cost.Components = Spawned[0]->GetComponents().Num();
+		}
+
+		for (APlayerCharacter* Character : Spawned)
+		{
+			Character->Destroy();
+		}
+		return Cost;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionCompareCharacterVariants(
+	TEXT("Locomotion.CompareCharacterVariants"),
+	TEXT("Locomotion.CompareCharacterVariants [Count] - Spawns Count unpossessed APlayerCharacter and ALightweightPlayerCharacter instances (100 by default) ")
+	TEXT("and logs the memory, spawn time and components per instance, and the actor object size."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+
+		// Lightweight first, so the full variant cannot reuse memory the other one freed
+		const FVariantCost Lightweight = MeasureVariant(World, ALightweightPlayerCharacter::StaticClass(), Count);
+		const FVariantCost Full = MeasureVariant(World, APlayerCharacter::StaticClass(), Count);
+
+		UE_LOG(LogLocomotion, Log, TEXT("APlayerCharacter:            %.3f ms spawn, %.1f KB, %d components per instance"), Full.SpawnMs, Full.MemoryKB, Full.Components);
+		UE_LOG(LogLocomotion, Log, TEXT("ALightweightPlayerCharacter: %.3f ms spawn, %.1f KB, %d components per instance"), Lightweight.SpawnMs, Lightweight.MemoryKB, Lightweight.Components);
+		UE_LOG(LogLocomotion, Log, TEXT("Saved per instance: %.3f ms spawn, %.1f KB"), Full.SpawnMs - Lightweight.SpawnMs, Full.MemoryKB - Lightweight.MemoryKB);
+		UE_LOG(LogLocomotion, Log, TEXT("Actor object: %d bytes, locomotion state: %d bytes, tuning: shared %d bytes"),
+			(int32)sizeof(APlayerCharacter), (int32)sizeof(FLocomotionState), (int32)sizeof(FLocomotionSettings));
+	}));
+
+ALightweightPlayerCharacter::ALightweightPlayerCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer
+		.DoNotCreateDefaultSubobject(APlayerCharacter::CameraBoomName)
+		.DoNotCreateDefaultSubobject(APlayerCharacter::FollowCameraName))
+{
+}
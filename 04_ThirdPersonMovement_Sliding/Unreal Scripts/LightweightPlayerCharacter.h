@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PlayerCharacter.h"
+#include "LightweightPlayerCharacter.generated.h"
+
+/**
+ * APlayerCharacter without a camera rig by default, for dedicated servers, AI and crowds. The spring arm and
+ * camera are created, and the input mapping added, only when a local player possesses the pawn, so other
+ * instances skip the two components, their registration and the spring arm's per-frame collision probe.
+ * The rig uses the APlayerCharacter defaults and cannot be edited in the Blueprint components panel.
+ *
+ * Locomotion.CompareCharacterVariants [Count] spawns both classes and logs the memory and spawn time per instance.
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ALightweightPlayerCharacter : public APlayerCharacter
+{
+	GENERATED_BODY()
+
+public:
+	ALightweightPlayerCharacter(const FObjectInitializer& ObjectInitializer);
+};
@@ -0,0 +1,31 @@
+#include "LocomotionAnimInstance.h"
+#include "PlayerCharacter.h"
+
+void ULocomotionAnimInstance::NativeInitializeAnimation()
+{
+	Super::NativeInitializeAnimation();
+
+	OwningCharacter = Cast<APlayerCharacter>(TryGetPawnOwner());
+}
+
+void ULocomotionAnimInstance::NativeThreadSafeUpdateAnimation(float DeltaSeconds)
+{
+	Super::NativeThreadSafeUpdateAnimation(DeltaSeconds);
+
+	if (!OwningCharacter)
+	{
+		return;
+	}
+
+	Snapshot = OwningCharacter->GetAnimSnapshot();
+
+	ForwardInput = Snapshot.ForwardInput;
+	bIsRunning = Snapshot.bIsRunning;
+	bIsSliding = Snapshot.bIsSliding;
+	bIsCrouching = Snapshot.bIsCrouching;
+	bIsProning = Snapshot.bIsProning;
+	bIsInProneTransition = Snapshot.bIsInProneTransition;
+	bIsJumping = Snapshot.bIsJumping;
+	bIsFlipping = Snapshot.bIsFlipping;
+	bIsDancing = Snapshot.bIsDancing;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "LocomotionAnimSnapshot.h"
+#include "LocomotionAnimInstance.generated.h"
+
+class APlayerCharacter;
+
+/**
+ * Anim instance base for APlayerCharacter. Reads the character's packed locomotion snapshot in
+ * NativeThreadSafeUpdateAnimation, so the animation update runs on worker threads without polling
+ * BlueprintCallable getters through the Blueprint VM. Blueprints bind their state machine to the members below.
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ULocomotionAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NativeInitializeAnimation() override;
+	virtual void NativeThreadSafeUpdateAnimation(float DeltaSeconds) override;
+
+protected:
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	FLocomotionAnimSnapshot Snapshot;
+
+	// Flattened copies, plain member reads stay on the animation fast path
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	float ForwardInput = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsRunning = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsSliding = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsCrouching = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsProning = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsInProneTransition = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsJumping = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsFlipping = false;
+
+	UPROPERTY(BlueprintReadOnly, Transient, Category = "Locomotion")
+	bool bIsDancing = false;
+
+private:
+	// Resolved on the game thread at initialization, only the snapshot atomic is read from workers
+	UPROPERTY(Transient)
+	TObjectPtr<APlayerCharacter> OwningCharacter;
+};
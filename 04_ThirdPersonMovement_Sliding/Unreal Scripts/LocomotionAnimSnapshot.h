@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LocomotionCore.h"
+#include "LocomotionAnimSnapshot.generated.h"
+
+/**
+ * Read-only view of the locomotion state for animation, published once per locomotion tick.
+ * Packs into 64 bits so the character can hand it to worker threads through one atomic.
+ */
+USTRUCT(BlueprintType)
+struct FLocomotionAnimSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	float ForwardInput = 0.f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsRunning : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsSliding : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsCrouching : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsProning : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsInProneTransition : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsJumping : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsFlipping : 1;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Locomotion")
+	uint8 bIsDancing : 1;
+
+	ELocomotionStance Stance = ELocomotionStance::Standing;
+
+	FLocomotionAnimSnapshot()
+		: bIsRunning(false), bIsSliding(false), bIsCrouching(false), bIsProning(false)
+		, bIsInProneTransition(false), bIsJumping(false), bIsFlipping(false), bIsDancing(false)
+	{
+	}
+
+	static FLocomotionAnimSnapshot FromState(const FLocomotionState& State)
+	{
+		FLocomotionAnimSnapshot Snapshot;
+		Snapshot.ForwardInput = State.MovementInput.Y;
+		Snapshot.bIsRunning = State.bIsRunning;
+		Snapshot.bIsSliding = State.IsSliding();
+		Snapshot.bIsCrouching = State.IsCrouching();
+		Snapshot.bIsProning = State.IsProning();
+		Snapshot.bIsInProneTransition = State.IsInProneTransition();
+		Snapshot.bIsJumping = State.IsJumping();
+		Snapshot.bIsFlipping = State.IsFlipping();
+		Snapshot.bIsDancing = State.IsDancing();
+		Snapshot.Stance = State.Stance;
+		return Snapshot;
+	}
+
+	// Forward input in the low 32 bits, flags in the next 8, stance above them
+	uint64 Pack() const
+	{
+		const uint64 Flags =
+			(bIsRunning ? 1u : 0u) | (bIsSliding ? 2u : 0u) | (bIsCrouching ? 4u : 0u) | (bIsProning ? 8u : 0u) |
+			(bIsInProneTransition ? 16u : 0u) | (bIsJumping ? 32u : 0u) | (bIsFlipping ? 64u : 0u) | (bIsDancing ? 128u : 0u);
+		uint32 ForwardBits = 0;
+		FMemory::Memcpy(&ForwardBits, &ForwardInput, sizeof(ForwardBits));
+		return static_cast<uint64>(ForwardBits) | (Flags << 32) | (static_cast<uint64>(Stance) << 40);
+	}
+
+	static FLocomotionAnimSnapshot Unpack(uint64 Packed)
+	{
+		FLocomotionAnimSnapshot Snapshot;
+		const uint32 ForwardBits = static_cast<uint32>(Packed);
+		FMemory::Memcpy(&Snapshot.ForwardInput, &ForwardBits, sizeof(ForwardBits));
+
+		const uint32 Flags = static_cast<uint32>(Packed >> 32) & 0xFF;
+		Snapshot.bIsRunning = (Flags & 1u) != 0;
+		Snapshot.bIsSliding = (Flags & 2u) != 0;
+		Snapshot.bIsCrouching = (Flags & 4u) != 0;
+		Snapshot.bIsProning = (Flags & 8u) != 0;
+		Snapshot.bIsInProneTransition = (Flags & 16u) != 0;
+		Snapshot.bIsJumping = (Flags & 32u) != 0;
+		Snapshot.bIsFlipping = (Flags & 64u) != 0;
+		Snapshot.bIsDancing = (Flags & 128u) != 0;
+		Snapshot.Stance = static_cast<ELocomotionStance>((Packed >> 40) & 0xFF);
+		return Snapshot;
+	}
+};
@@ -0,0 +1,107 @@
+#include "LocomotionCapsuleHistory.h"
+#include "LocomotionMovementComponent.h"
+#include "LocomotionSubsystem.h"
+#include "PlayerCharacter.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static FAutoConsoleCommandWithWorld CmdLocomotionCapsuleHistoryStats(
+	TEXT("Locomotion.CapsuleHistoryStats"),
+	TEXT("Locomotion.CapsuleHistoryStats - Logs the memory the lag compensation capsule histories use and the time they cover."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		int32 Characters = 0;
+		int32 Recording = 0;
+		double CoveredSeconds = 0.0;
+		for (TActorIterator<APlayerCharacter> It(World); It; ++It)
+		{
+			++Characters;
+			if (const ULocomotionMovementComponent* Movement = Cast<ULocomotionMovementComponent>(It->GetCharacterMovement()))
+			{
+				if (Movement->GetCapsuleHistory().Num() > 0)
+				{
+					++Recording;
+					CoveredSeconds += Movement->GetCapsuleHistory().GetCoveredSeconds();
+				}
+			}
+		}
+
+		const SIZE_T BytesPerCharacter = sizeof(FLocomotionCapsuleHistory);
+		UE_LOG(LogLocomotion, Log, TEXT("Capsule history: %d bytes per character (%d samples of %d bytes), %d characters, %.1f KB total, %d recording, %.0f ms covered on average"),
+			static_cast<int32>(BytesPerCharacter), FLocomotionCapsuleHistory::Capacity, static_cast<int32>(sizeof(FLocomotionCapsuleSample)),
+			Characters, Characters * BytesPerCharacter / 1024.0, Recording, Recording > 0 ? 1000.0 * CoveredSeconds / Recording : 0.0);
+	}));
+
+void FLocomotionCapsuleHistory::Record(double Time, const FVector& Location, float HalfHeight)
+{
+	if (NumSamples > 0)
+	{
+		const FLocomotionCapsuleSample& Last = GetSample(0);
+		if (Time < Last.Time + MinRecordInterval && HalfHeight == Last.HalfHeight)
+		{
+			return;
+		}
+	}
+
+	Newest = (Newest + 1) % Capacity;
+	NumSamples = FMath::Min(NumSamples + 1, Capacity);
+
+	FLocomotionCapsuleSample& Sample = Samples[Newest];
+	Sample.Time = Time;
+	Sample.Location = FVector3f(Location);
+	Sample.HalfHeight = HalfHeight;
+}
+
+bool FLocomotionCapsuleHistory::Rewind(double Time, FVector& OutLocation, float& OutHalfHeight) const
+{
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	const FLocomotionCapsuleSample& NewestSample = GetSample(0);
+	if (Time >= NewestSample.Time)
+	{
+		OutLocation = FVector(NewestSample.Location);
+		OutHalfHeight = NewestSample.HalfHeight;
+		return true;
+	}
+
+	if (Time < NewestSample.Time - MaxRewindSeconds || Time < GetSample(NumSamples - 1).Time)
+	{
+		return false;
+	}
+
+	// Newest first, the window is short enough that a linear walk beats a binary search
+	for (int32 AgeIndex = 1; AgeIndex < NumSamples; ++AgeIndex)
+	{
+		const FLocomotionCapsuleSample& Before = GetSample(AgeIndex);
+		if (Before.Time <= Time)
+		{
+			const FLocomotionCapsuleSample& After = GetSample(AgeIndex - 1);
+			const double Span = After.Time - Before.Time;
+			const float Alpha = Span > 0.0 ? static_cast<float>((Time - Before.Time) / Span) : 1.f;
+
+			OutLocation = FVector(FMath::Lerp(Before.Location, After.Location, Alpha));
+			OutHalfHeight = FMath::Lerp(Before.HalfHeight, After.HalfHeight, Alpha);
+			return true;
+		}
+	}
+	return false;
+}
+
+void FLocomotionCapsuleHistory::Reset()
+{
+	Newest = Capacity - 1;
+	NumSamples = 0;
+}
+
+double FLocomotionCapsuleHistory::GetCoveredSeconds() const
+{
+	return NumSamples > 1 ? GetSample(0).Time - GetSample(NumSamples - 1).Time : 0.0;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Capsule center and half-height at one server time. The location is stored in floats to keep a sample at 24 bytes
+struct FLocomotionCapsuleSample
+{
+	double Time = 0.0;
+	FVector3f Location = FVector3f::ZeroVector;
+	float HalfHeight = 0.f;
+};
+
+/**
+ * Server side history of a character's capsule for lag compensated hit validation. Slides, prone and crouch
+ * resize the capsule often, so a hit a high-latency client saw has to be checked against the capsule of that
+ * moment. Samples go into a fixed ring once per movement tick, and Rewind interpolates the center and
+ * half-height to any time in the last MaxRewindSeconds. Interpolating both keeps the capsule bottom on the
+ * floor across a resize. Capsules stay upright, so no rotation is kept.
+ */
+struct FLocomotionCapsuleHistory
+{
+	// 64 samples at up to 120 Hz cover 533 ms
+	static constexpr int32 Capacity = 64;
+	static constexpr double MinRecordInterval = 1.0 / 120.0;
+	static constexpr double MaxRewindSeconds = 0.5;
+
+	// Skips samples closer than MinRecordInterval to the newest one, unless the half-height changed
+	void Record(double Time, const FVector& Location, float HalfHeight);
+
+	// Capsule at Time. Times after the newest sample return the newest, times before the oldest sample
+	// or more than MaxRewindSeconds before the newest one fail
+	bool Rewind(double Time, FVector& OutLocation, float& OutHalfHeight) const;
+
+	void Reset();
+	int32 Num() const { return NumSamples; }
+	double GetCoveredSeconds() const;
+
+private:
+	const FLocomotionCapsuleSample& GetSample(int32 AgeIndex) const { return Samples[(Newest - AgeIndex + Capacity) % Capacity]; }
+
+	FLocomotionCapsuleSample Samples[Capacity];
+	int32 Newest = Capacity - 1;
+	int32 NumSamples = 0;
+};
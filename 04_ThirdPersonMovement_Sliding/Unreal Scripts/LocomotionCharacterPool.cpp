@@ -0,0 +1,289 @@
+#include "LocomotionCharacterPool.h"
+#include "LocomotionSubsystem.h"
+#include "LocomotionUtils.h"
+#include "PlayerCharacter.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static TAutoConsoleVariable<int32> CVarLocomotionCharacterPoolSize(
+	TEXT("Locomotion.CharacterPool.Size"),
+	0,
+	TEXT("Characters of the default pawn class the pool spawns when the level starts."));
+
+namespace
+{
+	// Upper bounds of the histogram buckets in ms, the last bucket takes everything slower
+	const double SpawnCostBucketsMs[] = { 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0 };
+	constexpr int32 NumSpawnCostBuckets = UE_ARRAY_COUNT(SpawnCostBucketsMs) + 1;
+
+	struct FSpawnCostHistogram
+	{
+		int32 Counts[NumSpawnCostBuckets] = {};
+		TArray<double> SamplesMs;
+
+		void Add(double Ms)
+		{
+			int32 Bucket = 0;
+			while (Bucket < UE_ARRAY_COUNT(SpawnCostBucketsMs) && Ms > SpawnCostBucketsMs[Bucket])
+			{
+				++Bucket;
+			}
+			++Counts[Bucket];
+			SamplesMs.Add(Ms);
+		}
+
+		// Call after the last Add
+		double GetPercentile(double Percentile)
+		{
+			if (SamplesMs.Num() == 0)
+			{
+				return 0.0;
+			}
+			SamplesMs.Sort();
+			const int32 Index = FMath::Clamp(FMath::CeilToInt(Percentile * SamplesMs.Num()) - 1, 0, SamplesMs.Num() - 1);
+			return SamplesMs[Index];
+		}
+	};
+
+	void LogSpawnCost(const TCHAR* Label, FSpawnCostHistogram& Histogram)
+	{
+		double Total = 0.0;
+		for (double Ms : Histogram.SamplesMs)
+		{
+			Total += Ms;
+		}
+		UE_LOG(LogLocomotion, Log, TEXT("%s: mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms"), Label,
+			Histogram.SamplesMs.Num() > 0 ? Total / Histogram.SamplesMs.Num() : 0.0,
+			Histogram.GetPercentile(0.5), Histogram.GetPercentile(0.99), Histogram.GetPercentile(1.0));
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionCharacterPoolHistogram(
+	TEXT("Locomotion.CharacterPoolHistogram"),
+	TEXT("Locomotion.CharacterPoolHistogram [Count] - Spawns Count characters of the default pawn class (100 by default) one at a time, ")
+	TEXT("then acquires as many from a prewarmed pool, and logs a histogram of the time per call for both."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		ULocomotionCharacterPool* Pool = World ? World->GetSubsystem<ULocomotionCharacterPool>() : nullptr;
+		if (!Pool)
+		{
+			return;
+		}
+
+		const int32 Count = Args.Num() > 0 ? FMath::Max(FCString::Atoi(*Args[0]), 1) : 100;
+		const TSubclassOf<APlayerCharacter> CharacterClass = Pool->GetDefaultCharacterClass();
+
+		FActorSpawnParameters Params;
+		Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		// Spawned away from the level, one call per sample
+		FSpawnCostHistogram Spawned;
+		TArray<APlayerCharacter*> Characters;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const FVector Location(Index * 200.f, 0.f, 50000.f);
+			const double StartSeconds = FPlatformTime::Seconds();
+			APlayerCharacter* Character = World->SpawnActor<APlayerCharacter>(CharacterClass, Location, FRotator::ZeroRotator, Params);
+			Spawned.Add((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+			if (Character)
+			{
+				Characters.Add(Character);
+			}
+		}
+		for (APlayerCharacter* Character : Characters)
+		{
+			Character->Destroy();
+		}
+		Characters.Reset();
+
+		// The prewarm is the load time cost the pool moves out of gameplay
+		const double PrewarmStartSeconds = FPlatformTime::Seconds();
+		Pool->Prewarm(CharacterClass, Count);
+		const double PrewarmMs = (FPlatformTime::Seconds() - PrewarmStartSeconds) * 1000.0;
+
+		FSpawnCostHistogram Pooled;
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			const FTransform Transform(FVector(Index * 200.f, 0.f, 50000.f));
+			const double StartSeconds = FPlatformTime::Seconds();
+			APlayerCharacter* Character = Pool->Acquire(CharacterClass, Transform);
+			Pooled.Add((FPlatformTime::Seconds() - StartSeconds) * 1000.0);
+			if (Character)
+			{
+				Characters.Add(Character);
+			}
+		}
+		for (APlayerCharacter* Character : Characters)
+		{
+			Pool->Release(Character);
+		}
+
+		UE_LOG(LogLocomotion, Log, TEXT("Spawn cost of %d %s, ms per call:"), Count, *CharacterClass->GetName());
+		UE_LOG(LogLocomotion, Log, TEXT("  bucket        spawn   pooled"));
+		for (int32 Bucket = 0; Bucket < NumSpawnCostBuckets; ++Bucket)
+		{
+			const FString Label = Bucket < UE_ARRAY_COUNT(SpawnCostBucketsMs)
+				? FString::Printf(TEXT("<= %6.3f"), SpawnCostBucketsMs[Bucket])
+				: FString::Printf(TEXT(" > %6.3f"), SpawnCostBucketsMs[Bucket - 1]);
+			UE_LOG(LogLocomotion, Log, TEXT("  %s   %6d   %6d"), *Label, Spawned.Counts[Bucket], Pooled.Counts[Bucket]);
+		}
+		LogSpawnCost(TEXT("Spawn"), Spawned);
+		LogSpawnCost(TEXT("Pooled"), Pooled);
+		UE_LOG(LogLocomotion, Log, TEXT("Prewarm: %.1f ms for %d characters, the pool keeps them"), PrewarmMs, Count);
+	}));
+
+bool ULocomotionCharacterPool::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void ULocomotionCharacterPool::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	const int32 Size = CVarLocomotionCharacterPoolSize.GetValueOnGameThread();
+	if (Size > 0)
+	{
+		Prewarm(GetDefaultCharacterClass(), Size);
+	}
+}
+
+void ULocomotionCharacterPool::Deinitialize()
+{
+	Inactive.Reset();
+	Owned.Reset();
+
+	Super::Deinitialize();
+}
+
+TSubclassOf<APlayerCharacter> ULocomotionCharacterPool::GetDefaultCharacterClass() const
+{
+	return LocomotionUtils::GetDefaultCharacterClass(GetWorld());
+}
+
+void ULocomotionCharacterPool::Prewarm(TSubclassOf<APlayerCharacter> CharacterClass, int32 Count)
+{
+	if (!CharacterClass)
+	{
+		return;
+	}
+
+	TArray<APlayerCharacter*>& Characters = Inactive.FindOrAdd(CharacterClass.Get());
+	Characters.Reserve(Count);
+	while (Characters.Num() < Count)
+	{
+		APlayerCharacter* Character = SpawnPooledCharacter(CharacterClass);
+		if (!Character)
+		{
+			break;
+		}
+		Deactivate(Character);
+		Characters.Add(Character);
+	}
+}
+
+APlayerCharacter* ULocomotionCharacterPool::Acquire(TSubclassOf<APlayerCharacter> CharacterClass, const FTransform& Transform)
+{
+	if (!CharacterClass)
+	{
+		CharacterClass = GetDefaultCharacterClass();
+	}
+
+	TArray<APlayerCharacter*>* Characters = Inactive.Find(CharacterClass.Get());
+	while (Characters && Characters->Num() > 0)
+	{
+		APlayerCharacter* Character = Characters->Pop(false);
+		if (IsValid(Character))
+		{
+			Activate(Character, Transform);
+			return Character;
+		}
+	}
+
+	// Empty pool, the caller pays the spawn
+	APlayerCharacter* Character = SpawnPooledCharacter(CharacterClass);
+	if (Character)
+	{
+		Character->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	}
+	return Character;
+}
+
+void ULocomotionCharacterPool::Release(APlayerCharacter* Character)
+{
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	TArray<APlayerCharacter*>& Characters = Inactive.FindOrAdd(Character->GetClass());
+	if (Characters.Contains(Character))
+	{
+		return;
+	}
+
+	Owned.AddUnique(Character);
+	Deactivate(Character);
+	Characters.Add(Character);
+}
+
+int32 ULocomotionCharacterPool::GetNumPooled(TSubclassOf<APlayerCharacter> CharacterClass) const
+{
+	const TArray<APlayerCharacter*>* Characters = Inactive.Find(CharacterClass.Get());
+	return Characters ? Characters->Num() : 0;
+}
+
+APlayerCharacter* ULocomotionCharacterPool::SpawnPooledCharacter(TSubclassOf<APlayerCharacter> CharacterClass)
+{
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	APlayerCharacter* Character = GetWorld()->SpawnActor<APlayerCharacter>(CharacterClass, FTransform::Identity, Params);
+	if (Character)
+	{
+		Owned.Add(Character);
+	}
+	return Character;
+}
+
+void ULocomotionCharacterPool::Activate(APlayerCharacter* Character, const FTransform& Transform)
+{
+	Character->SetActorTransform(Transform, false, nullptr, ETeleportType::ResetPhysics);
+	Character->ResetLocomotion();
+
+	Character->SetActorHiddenInGame(false);
+	Character->SetActorEnableCollision(true);
+	Character->GetCharacterMovement()->SetComponentTickEnabled(true);
+	Character->GetMesh()->SetComponentTickEnabled(true);
+	Character->SetActorTickEnabled(true);
+
+	// Back into the batched pass, which takes the actor tick over again
+	if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+	{
+		LocomotionSubsystem->RegisterCharacter(Character);
+	}
+}
+
+void ULocomotionCharacterPool::Deactivate(APlayerCharacter* Character)
+{
+	if (AController* Controller = Character->GetController())
+	{
+		Controller->UnPossess();
+	}
+
+	if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+	{
+		LocomotionSubsystem->UnregisterCharacter(Character);
+	}
+
+	Character->GetCharacterMovement()->StopMovementImmediately();
+	Character->GetCharacterMovement()->SetComponentTickEnabled(false);
+	Character->GetMesh()->SetComponentTickEnabled(false);
+	Character->SetActorTickEnabled(false);
+	Character->SetActorEnableCollision(false);
+	Character->SetActorHiddenInGame(true);
+}
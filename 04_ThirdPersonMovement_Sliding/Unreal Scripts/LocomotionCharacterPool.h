@@ -0,0 +1,54 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LocomotionCharacterPool.generated.h"
+
+class APlayerCharacter;
+
+/**
+ * Pre-spawned APlayerCharacter instances for respawn-heavy modes. Spawning a character creates and registers its
+ * components, its ticks and, once possessed, its camera rig, which hitches on respawn waves. The pool pays that at
+ * level load (Locomotion.CharacterPool.Size) or in Prewarm, then Acquire only moves, resets and shows a character
+ * and Release hides it again without destroying it. An empty pool falls back to spawning.
+ *
+ * Locomotion.CharacterPoolHistogram [Count] logs a spawn cost histogram with and without the pool.
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ULocomotionCharacterPool : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	// Spawns inactive characters until the pool holds Count of CharacterClass
+	void Prewarm(TSubclassOf<APlayerCharacter> CharacterClass, int32 Count);
+
+	// A pooled character reset to its spawn state at Transform, or a new one when the pool is empty
+	APlayerCharacter* Acquire(TSubclassOf<APlayerCharacter> CharacterClass, const FTransform& Transform);
+
+	// Unpossesses and deactivates Character and keeps it for the next Acquire
+	void Release(APlayerCharacter* Character);
+
+	int32 GetNumPooled(TSubclassOf<APlayerCharacter> CharacterClass) const;
+
+	// Class used when none is given: the game mode's default pawn when it is an APlayerCharacter
+	TSubclassOf<APlayerCharacter> GetDefaultCharacterClass() const;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	APlayerCharacter* SpawnPooledCharacter(TSubclassOf<APlayerCharacter> CharacterClass);
+	void Activate(APlayerCharacter* Character, const FTransform& Transform);
+	void Deactivate(APlayerCharacter* Character);
+
+	// Inactive characters per exact class, referenced through Owned
+	TMap<const UClass*, TArray<APlayerCharacter*>> Inactive;
+
+	// Every character the pool has held, kept referenced while inactive
+	UPROPERTY()
+	TArray<TObjectPtr<APlayerCharacter>> Owned;
+};
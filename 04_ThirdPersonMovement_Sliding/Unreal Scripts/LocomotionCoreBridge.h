@@ -0,0 +1,18 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LocomotionCore.h"
+
+// Conversions between Unreal math types and the engine-agnostic locomotion core
+namespace LocomotionBridge
+{
+	FORCEINLINE FLocomotionVector ToLocomotion(const FVector& Vector)
+	{
+		return FLocomotionVector(static_cast<float>(Vector.X), static_cast<float>(Vector.Y), static_cast<float>(Vector.Z));
+	}
+
+	FORCEINLINE FVector ToFVector(const FLocomotionVector& Vector)
+	{
+		return FVector(Vector.X, Vector.Y, Vector.Z);
+	}
+}
@@ -0,0 +1,114 @@
+#include "LocomotionDebug.h"
+
+#if LOCOMOTION_DEBUG
+
+#include "DrawDebugHelpers.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+namespace
+{
+	TAutoConsoleVariable<bool> CVarLocomotionDebugGround(
+		TEXT("Locomotion.Debug.Ground"),
+		false,
+		TEXT("Draw the locomotion ground queries."));
+
+	TAutoConsoleVariable<bool> CVarLocomotionDebugSlide(
+		TEXT("Locomotion.Debug.Slide"),
+		false,
+		TEXT("Draw slide slope and alignment, log ramp boosts and uphill penalties."));
+
+	TAutoConsoleVariable<bool> CVarLocomotionDebugStance(
+		TEXT("Locomotion.Debug.Stance"),
+		false,
+		TEXT("Log capsule changes from stance transitions."));
+
+	TMap<const UWorld*, FLocomotionDebugBuffer> Buffers;
+}
+
+bool FLocomotionDebugBuffer::IsEnabled(ELocomotionDebugCategory Category)
+{
+	switch (Category)
+	{
+	case ELocomotionDebugCategory::Ground:
+		return CVarLocomotionDebugGround.GetValueOnGameThread();
+	case ELocomotionDebugCategory::Slide:
+		return CVarLocomotionDebugSlide.GetValueOnGameThread();
+	case ELocomotionDebugCategory::Stance:
+		return CVarLocomotionDebugStance.GetValueOnGameThread();
+	default:
+		return false;
+	}
+}
+
+FLocomotionDebugBuffer* FLocomotionDebugBuffer::Get(const UWorld* World)
+{
+	check(IsInGameThread());
+	return World ? &Buffers.FindOrAdd(World) : nullptr;
+}
+
+void FLocomotionDebugBuffer::Release(const UWorld* World)
+{
+	Buffers.Remove(World);
+}
+
+FLocomotionDebugBuffer::FPrimitive& FLocomotionDebugBuffer::Push()
+{
+	if (Primitives.Num() == 0)
+	{
+		Primitives.SetNum(Capacity);
+	}
+
+	FPrimitive& Primitive = Primitives[(Head + Count) % Capacity];
+	if (Count < Capacity)
+	{
+		++Count;
+	}
+	else
+	{
+		Head = (Head + 1) % Capacity;
+	}
+	return Primitive;
+}
+
+void FLocomotionDebugBuffer::AddLine(const FVector& Start, const FVector& End, const FColor& Color, float Duration, float Thickness)
+{
+	FPrimitive& Primitive = Push();
+	Primitive.Start = Start;
+	Primitive.End = End;
+	Primitive.Text.Reset();
+	Primitive.Color = Color;
+	Primitive.Duration = Duration;
+	Primitive.Thickness = Thickness;
+}
+
+void FLocomotionDebugBuffer::AddString(const FVector& Location, FString&& Text, const FColor& Color, float Duration)
+{
+	FPrimitive& Primitive = Push();
+	Primitive.Start = Location;
+	Primitive.End = Location;
+	Primitive.Text = MoveTemp(Text);
+	Primitive.Color = Color;
+	Primitive.Duration = Duration;
+	Primitive.Thickness = 0.f;
+}
+
+void FLocomotionDebugBuffer::Flush(UWorld* World)
+{
+	for (int32 Offset = 0; Offset < Count; ++Offset)
+	{
+		const FPrimitive& Primitive = Primitives[(Head + Offset) % Capacity];
+		if (Primitive.Text.IsEmpty())
+		{
+			DrawDebugLine(World, Primitive.Start, Primitive.End, Primitive.Color, false, Primitive.Duration, 0, Primitive.Thickness);
+		}
+		else
+		{
+			DrawDebugString(World, Primitive.Start, Primitive.Text, nullptr, Primitive.Color, Primitive.Duration);
+		}
+	}
+	Head = 0;
+	Count = 0;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Locomotion debug draw and log calls compile to nothing in Shipping and Test builds
+#ifndef LOCOMOTION_DEBUG
+#define LOCOMOTION_DEBUG !(UE_BUILD_SHIPPING || UE_BUILD_TEST)
+#endif
+
+enum class ELocomotionDebugCategory : uint8
+{
+	Ground,
+	Slide,
+	Stance,
+	Num
+};
+
+#if LOCOMOTION_DEBUG
+
+class UWorld;
+
+/**
+ * Per-world ring buffer of debug primitives, drawn once per frame by ULocomotionSubsystem.
+ * When the buffer is full the oldest primitives are overwritten.
+ * Each category is switched on with Locomotion.Debug.Ground, Locomotion.Debug.Slide and Locomotion.Debug.Stance.
+ */
+class FLocomotionDebugBuffer
+{
+public:
+	static bool IsEnabled(ELocomotionDebugCategory Category);
+	static FLocomotionDebugBuffer* Get(const UWorld* World);
+	static void Release(const UWorld* World);
+
+	void AddLine(const FVector& Start, const FVector& End, const FColor& Color, float Duration, float Thickness);
+	void AddString(const FVector& Location, FString&& Text, const FColor& Color, float Duration);
+	void Flush(UWorld* World);
+
+private:
+	struct FPrimitive
+	{
+		FVector Start = FVector::ZeroVector;
+		FVector End = FVector::ZeroVector;
+		FString Text;
+		FColor Color = FColor::White;
+		float Duration = 0.f;
+		float Thickness = 0.f;
+	};
+
+	FPrimitive& Push();
+
+	static constexpr int32 Capacity = 1024;
+	TArray<FPrimitive> Primitives;
+	int32 Head = 0;
+	int32 Count = 0;
+};
+
+#define LOCOMOTION_DEBUG_LINE(World, Category, Start, End, Color, Duration, Thickness) \
+	do \
+	{ \
+		if (FLocomotionDebugBuffer::IsEnabled(ELocomotionDebugCategory::Category)) \
+		{ \
+			if (FLocomotionDebugBuffer* LocomotionDebugBuffer = FLocomotionDebugBuffer::Get(World)) \
+			{ \
+				LocomotionDebugBuffer->AddLine(Start, End, Color, Duration, Thickness); \
+			} \
+		} \
+	} while (0)
+
+#define LOCOMOTION_DEBUG_STRING(World, Category, Location, Text, Color, Duration) \
+	do \
+	{ \
+		if (FLocomotionDebugBuffer::IsEnabled(ELocomotionDebugCategory::Category)) \
+		{ \
+			if (FLocomotionDebugBuffer* LocomotionDebugBuffer = FLocomotionDebugBuffer::Get(World)) \
+			{ \
+				LocomotionDebugBuffer->AddString(Location, Text, Color, Duration); \
+			} \
+		} \
+	} while (0)
+
+#define LOCOMOTION_DEBUG_LOG(Category, Format, ...) \
+	do \
+	{ \
+		if (FLocomotionDebugBuffer::IsEnabled(ELocomotionDebugCategory::Category)) \
+		{ \
+			UE_LOG(LogLocomotion, Log, Format, ##__VA_ARGS__); \
+		} \
+	} while (0)
+
+#else
+
+#define LOCOMOTION_DEBUG_LINE(World, Category, Start, End, Color, Duration, Thickness) do {} while (0)
+#define LOCOMOTION_DEBUG_STRING(World, Category, Location, Text, Color, Duration) do {} while (0)
+#define LOCOMOTION_DEBUG_LOG(Category, Format, ...) do {} while (0)
+
+#endif
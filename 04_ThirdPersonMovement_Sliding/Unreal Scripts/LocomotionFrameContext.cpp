@@ -0,0 +1,71 @@
+#include "LocomotionFrameContext.h"
+#include "PlayerCharacter.h"
+#include "GameFramework/CharacterMovementComponent.h"
+
+void FLocomotionFrameContext::Begin(const APlayerCharacter& InOwner, uint64 InFrame)
+{
+	Owner = &InOwner;
+	Frame = InFrame;
+
+	const UCharacterMovementComponent* MoveComp = InOwner.GetCharacterMovement();
+	DeltaTime = InOwner.GetWorld()->GetDeltaSeconds() * InOwner.CustomTimeDilation;
+	bIsGrounded = MoveComp->IsMovingOnGround();
+	bIsFalling = MoveComp->IsFalling();
+
+	bHasCameraBasis = false;
+	InvalidateSpatialQueries();
+}
+
+void FLocomotionFrameContext::InvalidateSpatialQueries()
+{
+	bHasGround = false;
+	bHasClearance = false;
+}
+
+const FVector& FLocomotionFrameContext::GetCameraForward()
+{
+	ComputeCameraBasis();
+	return CameraForward;
+}
+
+const FVector& FLocomotionFrameContext::GetCameraRight()
+{
+	ComputeCameraBasis();
+	return CameraRight;
+}
+
+const FLocomotionGroundInfo& FLocomotionFrameContext::GetGround()
+{
+	if (!bHasGround)
+	{
+		Ground = Owner->QueryGroundInfo(APlayerCharacter::GroundProbeDistance);
+		bHasGround = true;
+	}
+	return Ground;
+}
+
+const FLocomotionClearance& FLocomotionFrameContext::GetClearance()
+{
+	if (!bHasClearance)
+	{
+		Clearance = Owner->QueryClearance();
+		bHasClearance = true;
+	}
+	return Clearance;
+}
+
+void FLocomotionFrameContext::ComputeCameraBasis()
+{
+	if (bHasCameraBasis)
+	{
+		return;
+	}
+
+	// Yaw only, movement stays on the horizontal plane. Pawns without a camera rig (AI, server) move along the view rotation the boom would follow
+	const float Yaw = Owner->FollowCamera ? Owner->FollowCamera->GetComponentRotation().Yaw : Owner->GetViewRotation().Yaw;
+	const FRotator CameraRot(0.f, Yaw, 0.f);
+	const FRotationMatrix Basis(CameraRot);
+	CameraForward = Basis.GetUnitAxis(EAxis::X);
+	CameraRight = Basis.GetUnitAxis(EAxis::Y);
+	bHasCameraBasis = true;
+}
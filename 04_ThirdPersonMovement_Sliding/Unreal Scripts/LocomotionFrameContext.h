@@ -0,0 +1,43 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "LocomotionCore.h"
+#include "LocomotionGroundInfo.h"
+
+class APlayerCharacter;
+
+/**
+ * Per-frame view of the world around one APlayerCharacter, shared by the tick and every input handler.
+ * Cheap values are read when the frame begins, the camera basis, ground and clearance are computed on first use
+ * and reused for the rest of the frame. Stance changes move the capsule, so they invalidate the spatial queries.
+ */
+struct FLocomotionFrameContext
+{
+	void Begin(const APlayerCharacter& InOwner, uint64 InFrame);
+	bool IsCurrent(uint64 InFrame) const { return Owner != nullptr && Frame == InFrame; }
+	void InvalidateSpatialQueries();
+
+	float DeltaTime = 0.f;
+	bool bIsGrounded = false;
+	bool bIsFalling = false;
+
+	const FVector& GetCameraForward();
+	const FVector& GetCameraRight();
+	const FLocomotionGroundInfo& GetGround();
+	const FLocomotionClearance& GetClearance();
+
+private:
+	void ComputeCameraBasis();
+
+	const APlayerCharacter* Owner = nullptr;
+	uint64 Frame = 0;
+
+	bool bHasCameraBasis = false;
+	bool bHasGround = false;
+	bool bHasClearance = false;
+
+	FVector CameraForward = FVector::ForwardVector;
+	FVector CameraRight = FVector::RightVector;
+	FLocomotionGroundInfo Ground;
+	FLocomotionClearance Clearance;
+};
@@ -0,0 +1,97 @@
+#include "LocomotionGroundInfo.h"
+#include "LocomotionSubsystem.h"
+#include "HAL/IConsoleManager.h"
+#include <atomic>
+
+namespace
+{
+	std::atomic<uint64> CharacterFrames { 0 };
+	std::atomic<uint64> FloorReuses { 0 };
+	std::atomic<uint64> Traces { 0 };
+	std::atomic<uint64> AsyncTraces { 0 };
+	std::atomic<uint64> ClearanceSweeps { 0 };
+	std::atomic<uint64> StanceChanges { 0 };
+	std::atomic<uint64> StanceSweeps { 0 };
+}
+
+static FAutoConsoleCommand CmdLocomotionGroundInfoStats(
+	TEXT("Locomotion.GroundInfoStats"),
+	TEXT("Locomotion.GroundInfoStats [reset] - Logs ground traces issued and avoided per character per frame, and the sweeps stance changes needed."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FLocomotionGroundInfoStats::Reset();
+			return;
+		}
+		FLocomotionGroundInfoStats::Log();
+	}));
+
+void FLocomotionGroundInfoStats::AddCharacterFrame()
+{
+	CharacterFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FLocomotionGroundInfoStats::AddFloorReuse()
+{
+	FloorReuses.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FLocomotionGroundInfoStats::AddTrace()
+{
+	Traces.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FLocomotionGroundInfoStats::AddAsyncTrace()
+{
+	AsyncTraces.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FLocomotionGroundInfoStats::AddClearanceSweep()
+{
+	ClearanceSweeps.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FLocomotionGroundInfoStats::AddStanceChange(bool bSwept)
+{
+	StanceChanges.fetch_add(1, std::memory_order_relaxed);
+	if (bSwept)
+	{
+		StanceSweeps.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+FLocomotionGroundInfoStats::FCounters FLocomotionGroundInfoStats::GetCounters()
+{
+	FCounters Counters;
+	Counters.CharacterFrames = CharacterFrames.load();
+	Counters.FloorReuses = FloorReuses.load();
+	Counters.Traces = Traces.load();
+	Counters.AsyncTraces = AsyncTraces.load();
+	Counters.ClearanceSweeps = ClearanceSweeps.load();
+	Counters.StanceChanges = StanceChanges.load();
+	Counters.StanceSweeps = StanceSweeps.load();
+	return Counters;
+}
+
+void FLocomotionGroundInfoStats::Reset()
+{
+	CharacterFrames = 0;
+	FloorReuses = 0;
+	Traces = 0;
+	AsyncTraces = 0;
+	ClearanceSweeps = 0;
+	StanceChanges = 0;
+	StanceSweeps = 0;
+}
+
+void FLocomotionGroundInfoStats::Log()
+{
+	const FCounters Counters = GetCounters();
+	const double Divisor = Counters.CharacterFrames > 0 ? static_cast<double>(Counters.CharacterFrames) : 1.0;
+
+	UE_LOG(LogLocomotion, Log, TEXT("Ground info over %llu character frames: %.3f traces/character/frame (%.3f async), %.3f traces avoided/character/frame (floor reused %llu times), %.3f clearance sweeps/character/frame"),
+		Counters.CharacterFrames, Counters.Traces / Divisor, Counters.AsyncTraces / Divisor, Counters.FloorReuses / Divisor, Counters.FloorReuses, Counters.ClearanceSweeps / Divisor);
+	UE_LOG(LogLocomotion, Log, TEXT("Stance changes: %llu, %llu swept (%.3f sweeps/change)"),
+		Counters.StanceChanges, Counters.StanceSweeps, Counters.StanceChanges > 0 ? static_cast<double>(Counters.StanceSweeps) / Counters.StanceChanges : 0.0);
+}
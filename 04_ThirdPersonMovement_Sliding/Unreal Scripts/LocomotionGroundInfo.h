@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Ground under a character, as seen from the actor location straight down.
+ * Filled from UCharacterMovementComponent::CurrentFloor whenever the movement component resolved a floor this frame,
+ * and from a line trace only when the character is airborne and the movement component has no floor.
+ */
+struct FLocomotionGroundInfo
+{
+	bool bHit = false;
+	bool bWalkable = false;
+	bool bFromMovementFloor = false;
+	float Distance = MAX_FLT;
+	FVector Normal = FVector::UpVector;
+};
+
+/**
+ * Counters for the ground queries, to confirm how many traces the floor reuse removes.
+ * Locomotion.GroundInfoStats logs the per character per frame averages, Locomotion.GroundInfoStats reset clears them.
+ */
+struct FLocomotionGroundInfoStats
+{
+	struct FCounters
+	{
+		uint64 CharacterFrames = 0;
+		uint64 FloorReuses = 0;
+		uint64 Traces = 0;
+		uint64 AsyncTraces = 0;
+		uint64 ClearanceSweeps = 0;
+		uint64 StanceChanges = 0;
+		uint64 StanceSweeps = 0;
+	};
+
+	static void AddCharacterFrame();
+	static void AddFloorReuse();
+	static void AddTrace();
+	static void AddAsyncTrace();
+	static void AddClearanceSweep();
+	static void AddStanceChange(bool bSwept);
+	static FCounters GetCounters();
+	static void Reset();
+	static void Log();
+};
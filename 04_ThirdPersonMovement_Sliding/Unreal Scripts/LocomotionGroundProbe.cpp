@@ -0,0 +1,50 @@
+#include "LocomotionGroundProbe.h"
+#include "LocomotionGroundInfo.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<bool> CVarLocomotionAsyncGroundProbes(
+	TEXT("Locomotion.AsyncGroundProbes"),
+	false,
+	TEXT("Issue slide and ground distance probes asynchronously one frame ahead, falling back to synchronous traces when no result is ready."));
+
+bool FLocomotionGroundProbe::IsAsyncEnabled()
+{
+	return CVarLocomotionAsyncGroundProbes.GetValueOnGameThread();
+}
+
+void FLocomotionGroundProbe::Issue(UWorld* World, const FVector& InStart, const FVector& End, const FCollisionQueryParams& Params)
+{
+	FLocomotionGroundInfoStats::AddAsyncTrace();
+	Handle = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, InStart, End, ECC_Visibility, Params);
+	IssuedFrame = GFrameCounter;
+	Start = InStart;
+}
+
+bool FLocomotionGroundProbe::TryGetResult(UWorld* World, FHitResult& OutHit, bool& bOutHit) const
+{
+	// Only a probe issued last frame describes where the character is now
+	if (!Handle.IsValid() || IssuedFrame + 1 != GFrameCounter)
+	{
+		return false;
+	}
+
+	FTraceDatum Data;
+	if (!World->QueryTraceData(Handle, Data))
+	{
+		return false;
+	}
+
+	bOutHit = Data.OutHits.Num() > 0 && Data.OutHits[0].bBlockingHit;
+	if (bOutHit)
+	{
+		OutHit = Data.OutHits[0];
+	}
+	return true;
+}
+
+void FLocomotionGroundProbe::Reset()
+{
+	Handle = FTraceHandle();
+	IssuedFrame = 0;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "WorldCollision.h"
+
+/**
+ * One pipelined downward line trace.
+ * Issue() queues an async trace during frame N, TryGetResult() hands the result back during frame N+1.
+ * When no result from the previous frame is ready the caller runs its synchronous trace instead.
+ * Enabled with Locomotion.AsyncGroundProbes.
+ */
+struct FLocomotionGroundProbe
+{
+	static bool IsAsyncEnabled();
+
+	void Issue(UWorld* World, const FVector& Start, const FVector& End, const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam);
+	bool TryGetResult(UWorld* World, FHitResult& OutHit, bool& bOutHit) const;
+	void Reset();
+
+	const FVector& GetStart() const { return Start; }
+
+private:
+	FTraceHandle Handle;
+	uint64 IssuedFrame = 0;
+	FVector Start = FVector::ZeroVector;
+};
@@ -0,0 +1,223 @@
+#include "LocomotionInputRecording.h"
+#include "PlayerCharacter.h"
+#include "LocomotionSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	constexpr int32 RecordsPerWrite = 4096;
+
+	APlayerCharacter* FindLocalCharacter(UWorld* World)
+	{
+		const APlayerController* PC = World ? World->GetFirstPlayerController() : nullptr;
+		return PC ? Cast<APlayerCharacter>(PC->GetPawn()) : nullptr;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionRecordInput(
+	TEXT("Locomotion.RecordInput"),
+	TEXT("Locomotion.RecordInput <File> - Records the local character's input events until Locomotion.StopInput."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		if (APlayerCharacter* Character = FindLocalCharacter(World))
+		{
+			Character->StartInputRecording(LocomotionInputRecording::ResolveFilename(Args.Num() > 0 ? Args[0] : TEXT("Recording")));
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionReplayInput(
+	TEXT("Locomotion.ReplayInput"),
+	TEXT("Locomotion.ReplayInput <File> [fast] [exit] - Replays a recording into the local character. fast runs on the recorded fixed time steps as quickly as possible, exit quits when done."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		APlayerCharacter* Character = FindLocalCharacter(World);
+		if (!Character || Args.Num() == 0)
+		{
+			return;
+		}
+
+		const bool bFastForward = Args.Contains(TEXT("fast"));
+		const bool bExitWhenDone = Args.Contains(TEXT("exit"));
+		Character->StartInputReplay(LocomotionInputRecording::ResolveFilename(Args[0]), bFastForward, bExitWhenDone);
+	}));
+
+static FAutoConsoleCommandWithWorld CmdLocomotionStopInput(
+	TEXT("Locomotion.StopInput"),
+	TEXT("Stops input recording or replay on the local character."),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (APlayerCharacter* Character = FindLocalCharacter(World))
+		{
+			Character->StopInputRecording();
+			Character->StopInputReplay();
+		}
+	}));
+
+FString LocomotionInputRecording::ResolveFilename(const FString& Name)
+{
+	FString Filename = FPaths::IsRelative(Name) ? FPaths::ProjectSavedDir() / TEXT("Locomotion") / Name : Name;
+	if (FPaths::GetExtension(Filename).IsEmpty())
+	{
+		Filename += TEXT(".locinput");
+	}
+	return Filename;
+}
+
+FLocomotionInputRecorder::~FLocomotionInputRecorder()
+{
+	Close();
+}
+
+bool FLocomotionInputRecorder::Open(const FString& Filename, const APlayerCharacter& Character)
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(Filename));
+
+	File.Reset(PlatformFile.OpenWrite(*Filename));
+	if (!File)
+	{
+		UE_LOG(LogLocomotion, Warning, TEXT("Could not open %s for input recording"), *Filename);
+		return false;
+	}
+
+	const FVector Location = Character.GetActorLocation();
+	const FRotator ControlRotation = Character.GetControlRotation();
+
+	Header = FLocomotionInputRecordingHeader();
+	Header.Location[0] = Location.X;
+	Header.Location[1] = Location.Y;
+	Header.Location[2] = Location.Z;
+	Header.ActorYaw = Character.GetActorRotation().Yaw;
+	Header.ControlPitch = ControlRotation.Pitch;
+	Header.ControlYaw = ControlRotation.Yaw;
+	Frame = 0;
+
+	// Placeholder header, rewritten with the counts on Close()
+	File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	Pending.Reserve(RecordsPerWrite);
+	return true;
+}
+
+void FLocomotionInputRecorder::Record(ELocomotionInputEvent Event, const FVector2D& Value)
+{
+	FLocomotionInputRecord& Record = Pending.AddDefaulted_GetRef();
+	Record.FrameAndEvent = (Frame << FLocomotionInputRecord::EventBits) | static_cast<uint32>(Event);
+	Record.X = static_cast<float>(Value.X);
+	Record.Y = static_cast<float>(Value.Y);
+
+	if (Pending.Num() >= RecordsPerWrite)
+	{
+		FlushRecords();
+	}
+}
+
+void FLocomotionInputRecorder::EndFrame(float DeltaTime)
+{
+	Record(ELocomotionInputEvent::Tick, FVector2D(DeltaTime, 0.f));
+	++Frame;
+}
+
+void FLocomotionInputRecorder::Close()
+{
+	if (!File)
+	{
+		return;
+	}
+
+	FlushRecords();
+
+	Header.NumFrames = Frame;
+	File->Seek(0);
+	File->Write(reinterpret_cast<const uint8*>(&Header), sizeof(Header));
+	File.Reset();
+
+	UE_LOG(LogLocomotion, Log, TEXT("Input recording closed: %u frames, %u events"), Header.NumFrames, Header.NumRecords);
+}
+
+void FLocomotionInputRecorder::FlushRecords()
+{
+	if (File && Pending.Num() > 0)
+	{
+		File->Write(reinterpret_cast<const uint8*>(Pending.GetData()), Pending.Num() * sizeof(FLocomotionInputRecord));
+		Header.NumRecords += Pending.Num();
+	}
+	Pending.Reset();
+}
+
+FLocomotionInputReplay::~FLocomotionInputReplay()
+{
+	// The region has to go before the file it maps
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+bool FLocomotionInputReplay::Open(const FString& Filename)
+{
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (!MappedFile || MappedFile->GetFileSize() < static_cast<int64>(sizeof(FLocomotionInputRecordingHeader)))
+	{
+		UE_LOG(LogLocomotion, Warning, TEXT("Could not map input recording %s"), *Filename);
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize()));
+	if (!MappedRegion)
+	{
+		return false;
+	}
+
+	FMemory::Memcpy(&Header, MappedRegion->GetMappedPtr(), sizeof(Header));
+
+	const int64 ExpectedSize = sizeof(Header) + static_cast<int64>(Header.NumRecords) * sizeof(FLocomotionInputRecord);
+	if (Header.Magic != FLocomotionInputRecordingHeader::ExpectedMagic || Header.Version != FLocomotionInputRecordingHeader::ExpectedVersion || MappedRegion->GetMappedSize() < ExpectedSize)
+	{
+		UE_LOG(LogLocomotion, Warning, TEXT("%s is not a complete locomotion input recording"), *Filename);
+		return false;
+	}
+
+	NextRecord = 0;
+	FramesPlayed = 0;
+	return true;
+}
+
+const FLocomotionInputRecord* FLocomotionInputReplay::GetRecords() const
+{
+	return reinterpret_cast<const FLocomotionInputRecord*>(MappedRegion->GetMappedPtr() + sizeof(FLocomotionInputRecordingHeader));
+}
+
+const FLocomotionInputRecord* FLocomotionInputReplay::NextEvent(float& OutDeltaTime)
+{
+	if (IsFinished())
+	{
+		return nullptr;
+	}
+
+	const FLocomotionInputRecord* Record = &GetRecords()[NextRecord++];
+	if (Record->GetEvent() == ELocomotionInputEvent::Tick)
+	{
+		OutDeltaTime = Record->X;
+		++FramesPlayed;
+		return nullptr;
+	}
+	return Record;
+}
+
+float FLocomotionInputReplay::PeekNextFrameDeltaTime() const
+{
+	const FLocomotionInputRecord* Records = GetRecords();
+	for (uint32 Index = NextRecord; Index < Header.NumRecords; ++Index)
+	{
+		if (Records[Index].GetEvent() == ELocomotionInputEvent::Tick)
+		{
+			return Records[Index].X;
+		}
+	}
+	return 0.f;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class APlayerCharacter;
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+// Input events bound in APlayerCharacter::SetupPlayerInputComponent, plus the per-frame Tick marker
+enum class ELocomotionInputEvent : uint8
+{
+	Tick,
+	Move,
+	Look,
+	RunPressed,
+	RunReleased,
+	Dance,
+	Jump,
+	CrouchPressed,
+	CrouchReleased,
+	Prone,
+	Num
+};
+
+/**
+ * One recorded event, 12 bytes. Frame index in the upper 28 bits, event in the lower 4.
+ * X / Y hold the axis value for Move and Look, and the frame delta time in X for Tick.
+ */
+struct FLocomotionInputRecord
+{
+	uint32 FrameAndEvent = 0;
+	float X = 0.f;
+	float Y = 0.f;
+
+	static constexpr uint32 EventBits = 4;
+
+	uint32 GetFrame() const { return FrameAndEvent >> EventBits; }
+	ELocomotionInputEvent GetEvent() const { return static_cast<ELocomotionInputEvent>(FrameAndEvent & ((1u << EventBits) - 1)); }
+};
+
+static_assert(sizeof(FLocomotionInputRecord) == 12, "Recordings are read straight from the mapped file");
+static_assert(static_cast<uint32>(ELocomotionInputEvent::Num) <= (1u << FLocomotionInputRecord::EventBits), "Input events must fit in the record event bits");
+
+// File header, followed by NumRecords records. Little-endian, as written by the recording machine
+struct FLocomotionInputRecordingHeader
+{
+	static constexpr uint32 ExpectedMagic = 0x524C434C; // "LCLR"
+	static constexpr uint32 ExpectedVersion = 1;
+
+	uint32 Magic = ExpectedMagic;
+	uint32 Version = ExpectedVersion;
+	uint32 NumRecords = 0;
+	uint32 NumFrames = 0;
+
+	// Where the recording started, the replay puts the character back here
+	float Location[3] = { 0.f, 0.f, 0.f };
+	float ActorYaw = 0.f;
+	float ControlPitch = 0.f;
+	float ControlYaw = 0.f;
+};
+
+/**
+ * Streams input events to disk. Events are buffered and written in blocks,
+ * the header is rewritten with the final counts on Close().
+ */
+class FLocomotionInputRecorder
+{
+public:
+	~FLocomotionInputRecorder();
+
+	bool Open(const FString& Filename, const APlayerCharacter& Character);
+	void Record(ELocomotionInputEvent Event, const FVector2D& Value);
+	// Closes the current frame, events recorded afterwards belong to the next one
+	void EndFrame(float DeltaTime);
+	void Close();
+
+private:
+	void FlushRecords();
+
+	TUniquePtr<IFileHandle> File;
+	FLocomotionInputRecordingHeader Header;
+	TArray<FLocomotionInputRecord> Pending;
+	uint32 Frame = 0;
+};
+
+/**
+ * Reads a recording through a memory mapped view, so long soak captures are paged in on demand.
+ */
+class FLocomotionInputReplay
+{
+public:
+	~FLocomotionInputReplay();
+
+	bool Open(const FString& Filename);
+
+	const FLocomotionInputRecordingHeader& GetHeader() const { return Header; }
+	bool IsFinished() const { return NextRecord >= Header.NumRecords; }
+	uint32 GetNumFramesPlayed() const { return FramesPlayed; }
+
+	// Next event of the current frame, nullptr once the frame's Tick marker has been read (returned through OutDeltaTime)
+	const FLocomotionInputRecord* NextEvent(float& OutDeltaTime);
+
+	// Delta time of the frame after the current one, 0 when the recording ends first
+	float PeekNextFrameDeltaTime() const;
+
+private:
+	const FLocomotionInputRecord* GetRecords() const;
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	FLocomotionInputRecordingHeader Header;
+	uint32 NextRecord = 0;
+	uint32 FramesPlayed = 0;
+};
+
+namespace LocomotionInputRecording
+{
+	// Relative names resolve to Saved/Locomotion/<Name>.locinput
+	FString ResolveFilename(const FString& Name);
+}
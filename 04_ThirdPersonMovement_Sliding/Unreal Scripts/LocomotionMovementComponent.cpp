@@ -0,0 +1,504 @@
+#include "LocomotionMovementComponent.h"
+#include "LocomotionCoreBridge.h"
+#include "LocomotionSubsystem.h"
+#include "PlayerCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "HAL/IConsoleManager.h"
+#include <atomic>
+
+namespace
+{
+	std::atomic<uint64> MovesChecked { 0 };
+	std::atomic<uint64> Corrections { 0 };
+
+	// Network stance per 2-bit code, sub-states travel as their parent
+	constexpr ELocomotionStance NetStances[] = { ELocomotionStance::Standing, ELocomotionStance::Crouching, ELocomotionStance::Proning, ELocomotionStance::Sliding };
+}
+
+static FAutoConsoleCommand CmdLocomotionNetStats(
+	TEXT("Locomotion.NetStats"),
+	TEXT("Locomotion.NetStats [reset] - Logs how many client moves the server checked and how many it corrected."),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("reset"))
+		{
+			FLocomotionNetStats::Reset();
+			return;
+		}
+		FLocomotionNetStats::Log();
+	}));
+
+void FLocomotionNetStats::AddMoveChecked(bool bCorrected)
+{
+	MovesChecked.fetch_add(1, std::memory_order_relaxed);
+	if (bCorrected)
+	{
+		Corrections.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+FLocomotionNetStats::FCounters FLocomotionNetStats::GetCounters()
+{
+	FCounters Counters;
+	Counters.MovesChecked = MovesChecked.load();
+	Counters.Corrections = Corrections.load();
+	return Counters;
+}
+
+void FLocomotionNetStats::Reset()
+{
+	MovesChecked = 0;
+	Corrections = 0;
+}
+
+void FLocomotionNetStats::Log()
+{
+	const FCounters Counters = GetCounters();
+	const double Divisor = Counters.MovesChecked > 0 ? static_cast<double>(Counters.MovesChecked) : 1.0;
+
+	UE_LOG(LogLocomotion, Log, TEXT("Net moves: %llu checked, %llu corrected (%.2f%%)"), Counters.MovesChecked, Counters.Corrections, 100.0 * Counters.Corrections / Divisor);
+}
+
+uint8 FSavedMove_Locomotion::PackLocomotionFlags(const FLocomotionState& State)
+{
+	const ELocomotionStance Parent = LocomotionStance::GetInfo(State.Stance).Parent;
+
+	uint8 StanceCode = 0;
+	for (uint8 Code = 0; Code < UE_ARRAY_COUNT(NetStances); ++Code)
+	{
+		if (NetStances[Code] == Parent)
+		{
+			StanceCode = Code;
+		}
+	}
+
+	return static_cast<uint8>(StanceCode << FLAG_StanceShift) | (State.bIsRunning ? FLAG_Running : 0) | (State.bJumpInputQueued ? FLAG_JumpQueued : 0);
+}
+
+uint8 FSavedMove_Locomotion::PackServerLocomotionFlags(const FLocomotionState& State)
+{
+	return static_cast<uint8>(PackLocomotionFlags(State) & ~FLAG_JumpQueued);
+}
+
+ELocomotionStance FSavedMove_Locomotion::UnpackStance(uint8 Flags)
+{
+	return NetStances[(Flags & FLAG_StanceMask) >> FLAG_StanceShift];
+}
+
+int16 FSavedMove_Locomotion::QuantizeSlideSpeed(float Speed)
+{
+	return static_cast<int16>(FMath::Clamp(FMath::RoundToInt(Speed), -MAX_int16, MAX_int16));
+}
+
+FLocomotionVector FSavedMove_Locomotion::DequantizeSlideVelocity(const int16 (&Quantized)[3])
+{
+	return FLocomotionVector(Quantized[0], Quantized[1], Quantized[2]);
+}
+
+void FSavedMove_Locomotion::Clear()
+{
+	Super::Clear();
+
+	LocomotionFlags = 0;
+	QuantizedSlideVelocity[0] = QuantizedSlideVelocity[1] = QuantizedSlideVelocity[2] = 0;
+	SlideFallTimer = 0.f;
+	SlideStartTimer = 0.f;
+	SlideStepAccumulator = 0.f;
+}
+
+uint8 FSavedMove_Locomotion::GetCompressedFlags() const
+{
+	return Super::GetCompressedFlags() | LocomotionFlags;
+}
+
+bool FSavedMove_Locomotion::CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const
+{
+	// Sliding moves each carry the velocity they started with
+	const FSavedMove_Locomotion* Other = static_cast<const FSavedMove_Locomotion*>(NewMove.Get());
+	if (LocomotionFlags != Other->LocomotionFlags || UnpackStance(LocomotionFlags) == ELocomotionStance::Sliding)
+	{
+		return false;
+	}
+	return Super::CanCombineWith(NewMove, InCharacter, MaxDelta);
+}
+
+void FSavedMove_Locomotion::SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData)
+{
+	Super::SetMoveFor(C, InDeltaTime, NewAccel, ClientData);
+
+	APlayerCharacter* Character = Cast<APlayerCharacter>(C);
+	if (!Character)
+	{
+		return;
+	}
+
+	FLocomotionState& State = Character->LocomotionState;
+	LocomotionFlags = PackLocomotionFlags(State);
+
+	if (State.IsSliding())
+	{
+		QuantizedSlideVelocity[0] = QuantizeSlideSpeed(State.SlideVelocity.X);
+		QuantizedSlideVelocity[1] = QuantizeSlideSpeed(State.SlideVelocity.Y);
+		QuantizedSlideVelocity[2] = QuantizeSlideSpeed(State.SlideVelocity.Z);
+
+		// Predict from exactly the velocity the server receives
+		State.SlideVelocity = DequantizeSlideVelocity(QuantizedSlideVelocity);
+	}
+
+	SlideFallTimer = State.SlideFallTimer;
+	SlideStartTimer = State.SlideStartTimer;
+	SlideStepAccumulator = State.SlideStepAccumulator;
+}
+
+void FSavedMove_Locomotion::PrepMoveFor(ACharacter* C)
+{
+	Super::PrepMoveFor(C);
+
+	// A replay re-runs the slide from the move's start, stance and run stay with input and the rules tick
+	APlayerCharacter* Character = Cast<APlayerCharacter>(C);
+	if (Character && Character->LocomotionState.IsSliding() && UnpackStance(LocomotionFlags) == ELocomotionStance::Sliding)
+	{
+		FLocomotionState& State = Character->LocomotionState;
+		State.SlideVelocity = DequantizeSlideVelocity(QuantizedSlideVelocity);
+		State.SlideFallTimer = SlideFallTimer;
+		State.SlideStartTimer = SlideStartTimer;
+		State.SlideStepAccumulator = SlideStepAccumulator;
+	}
+}
+
+FNetworkPredictionData_Client_Locomotion::FNetworkPredictionData_Client_Locomotion(const UCharacterMovementComponent& ClientMovement)
+	: Super(ClientMovement)
+{
+}
+
+FSavedMovePtr FNetworkPredictionData_Client_Locomotion::AllocateNewMove()
+{
+	return FSavedMovePtr(new FSavedMove_Locomotion());
+}
+
+void FLocomotionNetworkMoveData::ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType)
+{
+	Super::ClientFillNetworkMoveData(ClientMove, MoveType);
+
+	const FSavedMove_Locomotion& Move = static_cast<const FSavedMove_Locomotion&>(ClientMove);
+	FMemory::Memcpy(QuantizedSlideVelocity, Move.QuantizedSlideVelocity, sizeof(QuantizedSlideVelocity));
+}
+
+bool FLocomotionNetworkMoveData::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType)
+{
+	Super::Serialize(CharacterMovement, Ar, PackageMap, MoveType);
+
+	// The compressed flags are already read, only sliding moves carry the velocity
+	if (FSavedMove_Locomotion::UnpackStance(CompressedMoveFlags) == ELocomotionStance::Sliding)
+	{
+		Ar << QuantizedSlideVelocity[0];
+		Ar << QuantizedSlideVelocity[1];
+		Ar << QuantizedSlideVelocity[2];
+	}
+	else if (Ar.IsLoading())
+	{
+		QuantizedSlideVelocity[0] = QuantizedSlideVelocity[1] = QuantizedSlideVelocity[2] = 0;
+	}
+
+	return !Ar.IsError();
+}
+
+FLocomotionNetworkMoveDataContainer::FLocomotionNetworkMoveDataContainer()
+{
+	NewMoveData = &MoveData[0];
+	PendingMoveData = &MoveData[1];
+	OldMoveData = &MoveData[2];
+}
+
+void FLocomotionMoveResponseDataContainer::ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment)
+{
+	Super::ServerFillResponseData(CharacterMovement, PendingAdjustment);
+
+	// A queued jump is the client's own input, only stance and run are the server's to dictate
+	const APlayerCharacter* Character = Cast<APlayerCharacter>(CharacterMovement.GetCharacterOwner());
+	LocomotionFlags = Character ? FSavedMove_Locomotion::PackServerLocomotionFlags(Character->LocomotionState) : 0;
+}
+
+bool FLocomotionMoveResponseDataContainer::Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap)
+{
+	if (!Super::Serialize(CharacterMovement, Ar, PackageMap))
+	{
+		return false;
+	}
+
+	// Acknowledged moves already agree with the server
+	if (IsCorrection())
+	{
+		Ar << LocomotionFlags;
+	}
+
+	return !Ar.IsError();
+}
+
+ULocomotionMovementComponent::ULocomotionMovementComponent(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	SetNetworkMoveDataContainer(LocomotionMoveDataContainer);
+	SetMoveResponseDataContainer(LocomotionMoveResponseDataContainer);
+}
+
+bool ULocomotionMovementComponent::IsSliding() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(ELocomotionMovementMode::Slide);
+}
+
+bool ULocomotionMovementComponent::WantsSlideMode() const
+{
+	return LocomotionCharacter && LocomotionCharacter->GetLocomotionSettings().bSlideInMovementMode && LocomotionCharacter->LocomotionState.IsSliding();
+}
+
+void ULocomotionMovementComponent::StartSlideMode()
+{
+	if (MovementMode == MOVE_Walking && WantsSlideMode())
+	{
+		SetMovementMode(MOVE_Custom, static_cast<uint8>(ELocomotionMovementMode::Slide));
+	}
+}
+
+void ULocomotionMovementComponent::StopSlideMode()
+{
+	if (IsSliding())
+	{
+		SetMovementMode(MOVE_Walking);
+	}
+}
+
+void ULocomotionMovementComponent::ResetLocomotionMovement()
+{
+	StopMovementImmediately();
+	SetDefaultMovementMode();
+	CapsuleHistory.Reset();
+	bLastMoveJumpQueued = false;
+}
+
+void ULocomotionMovementComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	// Only a server validates hits, and only against where its characters have been
+	if (CharacterOwner && UpdatedComponent && CharacterOwner->HasAuthority() && GetNetMode() != NM_Standalone)
+	{
+		CapsuleHistory.Record(GetWorld()->GetTimeSeconds(), UpdatedComponent->GetComponentLocation(), CharacterOwner->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+
+		// Simulated proxies follow the stance through the replicated flags, and the net rate follows this move's velocity and mode
+		if (LocomotionCharacter)
+		{
+			LocomotionCharacter->ReplicatedLocomotionFlags = FSavedMove_Locomotion::PackServerLocomotionFlags(LocomotionCharacter->LocomotionState);
+			LocomotionCharacter->UpdateNetUpdateRate();
+		}
+	}
+}
+
+void ULocomotionMovementComponent::SetUpdatedComponent(USceneComponent* NewUpdatedComponent)
+{
+	Super::SetUpdatedComponent(NewUpdatedComponent);
+
+	LocomotionCharacter = Cast<APlayerCharacter>(CharacterOwner);
+}
+
+bool ULocomotionMovementComponent::IsMovingOnGround() const
+{
+	// Jumps, floor reuse and the locomotion rules treat the slide like walking
+	return Super::IsMovingOnGround() || (IsSliding() && UpdatedComponent);
+}
+
+float ULocomotionMovementComponent::GetMaxSpeed() const
+{
+	if (!LocomotionCharacter)
+	{
+		return Super::GetMaxSpeed();
+	}
+
+	if (IsSliding())
+	{
+		return LocomotionCharacter->GetLocomotionSettings().MaxSlideSpeed;
+	}
+
+	// Walking speed follows the predicted stance and run flag rather than MaxWalkSpeed, so both ends agree.
+	// Move input turns the character to face it, accelerating against the facing is backwards input
+	float MaxSpeed = 0.f;
+	if (MovementMode == MOVE_Walking && UpdatedComponent)
+	{
+		const float ForwardInput = FVector::DotProduct(Acceleration, UpdatedComponent->GetForwardVector());
+		if (Locomotion::ResolveMaxWalkSpeed(LocomotionCharacter->LocomotionState, LocomotionCharacter->GetLocomotionSettings(), ForwardInput, MaxSpeed))
+		{
+			return MaxSpeed;
+		}
+	}
+	return Super::GetMaxSpeed();
+}
+
+FNetworkPredictionData_Client* ULocomotionMovementComponent::GetPredictionData_Client() const
+{
+	if (!ClientPredictionData)
+	{
+		ULocomotionMovementComponent* MutableThis = const_cast<ULocomotionMovementComponent*>(this);
+		MutableThis->ClientPredictionData = new FNetworkPredictionData_Client_Locomotion(*this);
+	}
+	return ClientPredictionData;
+}
+
+void ULocomotionMovementComponent::UpdateFromCompressedFlags(uint8 Flags)
+{
+	Super::UpdateFromCompressedFlags(Flags);
+
+	// Only the server applies the client's flags, a replaying client restores its own state in PrepMoveFor
+	if (!LocomotionCharacter || CharacterOwner->GetLocalRole() != ROLE_Authority)
+	{
+		return;
+	}
+
+	const bool bJumpQueued = (Flags & FSavedMove_Locomotion::FLAG_JumpQueued) != 0;
+	const bool bRunning = (Flags & FSavedMove_Locomotion::FLAG_Running) != 0;
+	LocomotionCharacter->ApplyMoveLocomotionFlags(FSavedMove_Locomotion::UnpackStance(Flags), bRunning, bJumpQueued && !bLastMoveJumpQueued);
+	bLastMoveJumpQueued = bJumpQueued;
+
+	// Clamped, a client cannot slide faster than the rules allow
+	const FLocomotionNetworkMoveData* MoveData = static_cast<const FLocomotionNetworkMoveData*>(GetCurrentNetworkMoveData());
+	FLocomotionState& State = LocomotionCharacter->LocomotionState;
+	if (MoveData && State.IsSliding())
+	{
+		State.SlideVelocity = FSavedMove_Locomotion::DequantizeSlideVelocity(MoveData->QuantizedSlideVelocity).GetClampedToMaxSize(LocomotionCharacter->GetLocomotionSettings().MaxSlideSpeed);
+	}
+}
+
+void ULocomotionMovementComponent::ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse)
+{
+	// The server's stance goes in before the adjustment replays the unacknowledged moves from it
+	if (LocomotionCharacter && MoveResponse.IsCorrection())
+	{
+		const uint8 Flags = static_cast<const FLocomotionMoveResponseDataContainer&>(MoveResponse).LocomotionFlags;
+		LocomotionCharacter->ApplyServerLocomotionFlags(FSavedMove_Locomotion::UnpackStance(Flags), (Flags & FSavedMove_Locomotion::FLAG_Running) != 0);
+	}
+
+	Super::ClientHandleMoveResponse(MoveResponse);
+}
+
+bool ULocomotionMovementComponent::ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc,
+	UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode)
+{
+	const bool bError = Super::ServerCheckClientError(ClientTimeStamp, DeltaTime, Accel, ClientLoc, RelativeClientLoc, ClientMovementBase, ClientBaseBoneName, ClientMovementMode);
+	FLocomotionNetStats::AddMoveChecked(bError);
+	return bError;
+}
+
+void ULocomotionMovementComponent::PhysCustom(float DeltaTime, int32 Iterations)
+{
+	if (CustomMovementMode == static_cast<uint8>(ELocomotionMovementMode::Slide))
+	{
+		PhysSlide(DeltaTime, Iterations);
+		return;
+	}
+	Super::PhysCustom(DeltaTime, Iterations);
+}
+
+void ULocomotionMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	// Custom modes clear the floor and base, the slide stands on them like walking does
+	if (IsSliding())
+	{
+		Velocity.Z = 0.f;
+		FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+		AdjustFloorHeight();
+		SetBaseFromFloor(CurrentFloor);
+	}
+}
+
+void ULocomotionMovementComponent::SetPostLandedPhysics(const FHitResult& Hit)
+{
+	Super::SetPostLandedPhysics(Hit);
+
+	// A slide started or carried through the air continues on landing
+	StartSlideMode();
+}
+
+void ULocomotionMovementComponent::PhysSlide(float DeltaTime, int32 Iterations)
+{
+	if (DeltaTime < MIN_TICK_TIME)
+	{
+		return;
+	}
+
+	// The slide ended outside the mode (crouch release), walk the rest of the frame
+	if (!WantsSlideMode())
+	{
+		SetMovementMode(MOVE_Walking);
+		StartNewPhysics(DeltaTime, Iterations);
+		return;
+	}
+
+	FLocomotionState& State = LocomotionCharacter->LocomotionState;
+	const FLocomotionSettings& Settings = LocomotionCharacter->GetLocomotionSettings();
+
+	float RemainingTime = DeltaTime;
+	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations && UpdatedComponent)
+	{
+		Iterations++;
+		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+		RemainingTime -= TimeTick;
+
+		// Slide rules on the floor the last move ended on, with the same step as the move
+		FLocomotionTickInput Input;
+		Input.DeltaTime = TimeTick;
+		Input.Time = GetWorld()->GetTimeSeconds();
+		Input.bIsGrounded = true;
+		Input.ActorForward = LocomotionBridge::ToLocomotion(UpdatedComponent->GetForwardVector());
+		Input.bHasSlideGroundHit = CurrentFloor.bBlockingHit;
+		Input.SlideGroundNormal = LocomotionBridge::ToLocomotion(CurrentFloor.HitResult.ImpactNormal);
+
+		FLocomotionTickOutput Output;
+		float SlideSpeed = 0.f;
+		const bool bKeepSliding = Locomotion::StepSlideMovement(State, Settings, Input, Output, SlideSpeed);
+		LocomotionCharacter->DrawSlideDebug(Output);
+
+		if (!bKeepSliding)
+		{
+			// Resizes the capsule and switches to walking, which takes the rest of the frame
+			LocomotionCharacter->ExitSlide();
+			StartNewPhysics(RemainingTime + TimeTick, Iterations - 1);
+			return;
+		}
+
+		// The slide velocity is the horizontal intent, the floor move adds the ramp's vertical part
+		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+		const FVector SlideVelocity = LocomotionBridge::ToFVector(State.SlideVelocity);
+		Velocity = FVector(SlideVelocity.X, SlideVelocity.Y, 0.f);
+
+		FStepDownResult StepDownResult;
+		MoveAlongFloor(Velocity, TimeTick, &StepDownResult);
+
+		if (StepDownResult.bComputedFloor)
+		{
+			CurrentFloor = StepDownResult.FloorResult;
+		}
+		else
+		{
+			FindFloor(UpdatedComponent->GetComponentLocation(), CurrentFloor, false);
+		}
+
+		if (!bJustTeleported)
+		{
+			Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / TimeTick;
+			MaintainHorizontalGroundVelocity();
+		}
+
+		// Off a ledge or onto a steep slope the slide stance falls, the rules run the airborne grace
+		// and SetPostLandedPhysics resumes the mode
+		if (!CurrentFloor.IsWalkableFloor())
+		{
+			SetMovementMode(MOVE_Falling);
+			StartNewPhysics(RemainingTime, Iterations);
+			return;
+		}
+
+		AdjustFloorHeight();
+		SetBaseFromFloor(CurrentFloor);
+	}
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "LocomotionCapsuleHistory.h"
+#include "LocomotionCore.h"
+#include "LocomotionMovementComponent.generated.h"
+
+class APlayerCharacter;
+
+// CustomMovementMode values used with MOVE_Custom
+UENUM(BlueprintType)
+enum class ELocomotionMovementMode : uint8
+{
+	None UMETA(Hidden),
+	Slide
+};
+
+/**
+ * Locomotion state carried by a client move. Stance (2 bits), run and jump-queued ride in the four custom
+ * compressed flags, so only a sliding move adds a payload: the slide velocity quantized to 1 unit/s in int16s.
+ */
+class FSavedMove_Locomotion : public FSavedMove_Character
+{
+public:
+	typedef FSavedMove_Character Super;
+
+	static constexpr uint8 FLAG_StanceMask = FLAG_Custom_0 | FLAG_Custom_1;
+	static constexpr uint8 FLAG_StanceShift = 4;
+	static constexpr uint8 FLAG_Running = FLAG_Custom_2;
+	static constexpr uint8 FLAG_JumpQueued = FLAG_Custom_3;
+
+	// Standing/dancing, crouching, proning or sliding, sub-states are animation only
+	static uint8 PackLocomotionFlags(const FLocomotionState& State);
+	static ELocomotionStance UnpackStance(uint8 Flags);
+	// Stance and run without the jump queue, the part the server sends back to clients
+	static uint8 PackServerLocomotionFlags(const FLocomotionState& State);
+
+	static int16 QuantizeSlideSpeed(float Speed);
+	static FLocomotionVector DequantizeSlideVelocity(const int16 (&Quantized)[3]);
+
+	virtual void Clear() override;
+	virtual uint8 GetCompressedFlags() const override;
+	virtual bool CanCombineWith(const FSavedMovePtr& NewMove, ACharacter* InCharacter, float MaxDelta) const override;
+	virtual void SetMoveFor(ACharacter* C, float InDeltaTime, FVector const& NewAccel, FNetworkPredictionData_Client_Character& ClientData) override;
+	virtual void PrepMoveFor(ACharacter* C) override;
+
+	uint8 LocomotionFlags = 0;
+	int16 QuantizedSlideVelocity[3] = { 0, 0, 0 };
+
+	// Slide timers at the start of the move, restored when the move is replayed after a correction
+	float SlideFallTimer = 0.f;
+	float SlideStartTimer = 0.f;
+	float SlideStepAccumulator = 0.f;
+};
+
+class FNetworkPredictionData_Client_Locomotion : public FNetworkPredictionData_Client_Character
+{
+public:
+	typedef FNetworkPredictionData_Client_Character Super;
+
+	explicit FNetworkPredictionData_Client_Locomotion(const UCharacterMovementComponent& ClientMovement);
+
+	virtual FSavedMovePtr AllocateNewMove() override;
+};
+
+// Move RPC data, appends the quantized slide velocity to sliding moves
+struct FLocomotionNetworkMoveData : public FCharacterNetworkMoveData
+{
+	typedef FCharacterNetworkMoveData Super;
+
+	virtual void ClientFillNetworkMoveData(const FSavedMove_Character& ClientMove, ENetworkMoveType MoveType) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap, ENetworkMoveType MoveType) override;
+
+	int16 QuantizedSlideVelocity[3] = { 0, 0, 0 };
+};
+
+struct FLocomotionNetworkMoveDataContainer : public FCharacterNetworkMoveDataContainer
+{
+	FLocomotionNetworkMoveDataContainer();
+
+	FLocomotionNetworkMoveData MoveData[3];
+};
+
+// Move response, a correction also carries the server's stance and run flag back to the owning client
+struct FLocomotionMoveResponseDataContainer : public FCharacterMoveResponseDataContainer
+{
+	typedef FCharacterMoveResponseDataContainer Super;
+
+	virtual void ServerFillResponseData(const UCharacterMovementComponent& CharacterMovement, const FClientAdjustment& PendingAdjustment) override;
+	virtual bool Serialize(UCharacterMovementComponent& CharacterMovement, FArchive& Ar, UPackageMap* PackageMap) override;
+
+	uint8 LocomotionFlags = 0;
+};
+
+/**
+ * Server side move counters for the network soak. Locomotion.NetStats logs the correction rate, Locomotion.NetStats reset clears it.
+ */
+struct FLocomotionNetStats
+{
+	struct FCounters
+	{
+		uint64 MovesChecked = 0;
+		uint64 Corrections = 0;
+	};
+
+	static void AddMoveChecked(bool bCorrected);
+	static FCounters GetCounters();
+	static void Reset();
+	static void Log();
+};
+
+/**
+ * Character movement with a dedicated slide mode. While APlayerCharacter slides, the component runs
+ * MOVE_Custom / Slide, and PhysSlide integrates the slide rules, moves along the floor and finds the next
+ * floor in one place, instead of steering the walking physics through MaxWalkSpeed and movement input.
+ *
+ * Stance, run and jump input are predicted through FSavedMove_Locomotion. The max speed comes from the
+ * predicted stance rather than MaxWalkSpeed, so the server and the owning client agree on it every move.
+ * A correction brings the server's stance and run flag back in the move response, and simulated proxies
+ * receive them through APlayerCharacter::ReplicatedLocomotionFlags.
+ *
+ * On a server the component records the capsule after every tick for lag compensated hit validation.
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ULocomotionMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	ULocomotionMovementComponent(const FObjectInitializer& ObjectInitializer);
+
+	bool IsSliding() const;
+
+	// Slide start and exit on the character. Starting in the air waits for the landing
+	void StartSlideMode();
+	void StopSlideMode();
+
+	// Server side capsule history, see FLocomotionCapsuleHistory
+	const FLocomotionCapsuleHistory& GetCapsuleHistory() const { return CapsuleHistory; }
+
+	// Pooled characters: stops all movement and forgets the capsule history and the last client move
+	void ResetLocomotionMovement();
+
+	virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+	virtual void SetUpdatedComponent(USceneComponent* NewUpdatedComponent) override;
+	virtual bool IsMovingOnGround() const override;
+	virtual float GetMaxSpeed() const override;
+	virtual FNetworkPredictionData_Client* GetPredictionData_Client() const override;
+
+protected:
+	virtual void PhysCustom(float DeltaTime, int32 Iterations) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+	virtual void SetPostLandedPhysics(const FHitResult& Hit) override;
+	virtual void UpdateFromCompressedFlags(uint8 Flags) override;
+	virtual void ClientHandleMoveResponse(const FCharacterMoveResponseDataContainer& MoveResponse) override;
+	virtual bool ServerCheckClientError(float ClientTimeStamp, float DeltaTime, const FVector& Accel, const FVector& ClientLoc, const FVector& RelativeClientLoc,
+		UPrimitiveComponent* ClientMovementBase, FName ClientBaseBoneName, uint8 ClientMovementMode) override;
+
+	void PhysSlide(float DeltaTime, int32 Iterations);
+
+private:
+	bool WantsSlideMode() const;
+
+	UPROPERTY(Transient)
+	TObjectPtr<APlayerCharacter> LocomotionCharacter;
+
+	FLocomotionNetworkMoveDataContainer LocomotionMoveDataContainer;
+	FLocomotionMoveResponseDataContainer LocomotionMoveResponseDataContainer;
+
+	FLocomotionCapsuleHistory CapsuleHistory;
+
+	// Jump-queued flag of the last move the server applied, a queue only starts on its rising edge
+	bool bLastMoveJumpQueued = false;
+};
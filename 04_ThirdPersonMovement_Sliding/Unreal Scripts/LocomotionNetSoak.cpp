@@ -0,0 +1,393 @@
+#include "LocomotionNetSoak.h"
+#include "PlayerCharacter.h"
+#include "LocomotionMovementComponent.h"
+#include "LocomotionPerfSuite.h"
+#include "LocomotionSubsystem.h"
+#include "LocomotionUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/NetDriver.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+
+namespace
+{
+	const TCHAR* CsvHeader = TEXT("Characters,Seconds,InBytesPerCharacterSecond,OutBytesPerCharacterSecond,OutKBPerSecond,MovesPerCharacterSecond,CorrectionPercent,ServerFrameMs,ServerCPUPercent");
+
+	// A PIE client console runs the soak on the server world of the same session
+	UWorld* FindSoakWorld(UWorld* World)
+	{
+		if (!World || World->WorldType != EWorldType::PIE || World->GetNetMode() != NM_Client || !GEngine)
+		{
+			return World;
+		}
+
+		for (const FWorldContext& Context : GEngine->GetWorldContexts())
+		{
+			UWorld* Candidate = Context.World();
+			if (Candidate && Candidate->WorldType == EWorldType::PIE && Candidate->GetNetMode() != NM_Client && Candidate->GetNetMode() != NM_Standalone)
+			{
+				return Candidate;
+			}
+		}
+		return World;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionNetSoak(
+	TEXT("Locomotion.NetSoak"),
+	TEXT("Locomotion.NetSoak [seconds=N] [warmup=N] [out=File] [players=N,N] [client=Exe] [timeout=N] [exit] - Drives every client character with the bot script and reports ")
+	TEXT("bytes per character per second, server frame time and CPU, and the move correction rate. players= launches headless clients from a dedicated server."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		World = FindSoakWorld(World);
+		ULocomotionNetSoak* Soak = World ? World->GetSubsystem<ULocomotionNetSoak>() : nullptr;
+		if (!Soak || Soak->IsRunning())
+		{
+			return;
+		}
+
+		ULocomotionNetSoak::FOptions Options;
+		Options.OutputPath = FPaths::ProjectSavedDir() / TEXT("Locomotion") / TEXT("NetSoak.csv");
+
+		for (const FString& Arg : Args)
+		{
+			FString Key;
+			FString Value;
+			if (!Arg.Split(TEXT("="), &Key, &Value))
+			{
+				if (Arg == TEXT("exit"))
+				{
+					Options.bExitWhenDone = true;
+				}
+				continue;
+			}
+
+			if (Key == TEXT("seconds"))
+			{
+				Options.Seconds = FMath::Max(FCString::Atof(*Value), 1.f);
+			}
+			else if (Key == TEXT("warmup"))
+			{
+				Options.WarmupSeconds = FMath::Max(FCString::Atof(*Value), 0.f);
+			}
+			else if (Key == TEXT("out"))
+			{
+				Options.OutputPath = LocomotionUtils::ResolvePath(Value, FPaths::ProjectSavedDir() / TEXT("Locomotion"));
+			}
+			else if (Key == TEXT("players"))
+			{
+				TArray<FString> Counts;
+				Value.ParseIntoArray(Counts, TEXT(","));
+				for (const FString& Count : Counts)
+				{
+					Options.PlayerCounts.Add(FMath::Max(FCString::Atoi(*Count), 1));
+				}
+			}
+			else if (Key == TEXT("client"))
+			{
+				Options.ClientExecutable = Value;
+			}
+			else if (Key == TEXT("timeout"))
+			{
+				Options.ConnectTimeoutSeconds = FMath::Max(FCString::Atof(*Value), 1.f);
+			}
+		}
+
+		Soak->Start(Options);
+	}));
+
+bool ULocomotionNetSoak::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId ULocomotionNetSoak::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULocomotionNetSoak, STATGROUP_Tickables);
+}
+
+void ULocomotionNetSoak::Deinitialize()
+{
+	bRunning = false;
+	bMeasuring = false;
+	TerminateClients();
+
+	Super::Deinitialize();
+}
+
+bool ULocomotionNetSoak::IsServer() const
+{
+	const ENetMode NetMode = GetWorld()->GetNetMode();
+	return NetMode == NM_ListenServer || NetMode == NM_DedicatedServer;
+}
+
+int32 ULocomotionNetSoak::GetNumCharacters() const
+{
+	const ULocomotionSubsystem* Subsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>();
+	return Subsystem ? Subsystem->GetNumCharacters() : 0;
+}
+
+void ULocomotionNetSoak::Start(const FOptions& InOptions)
+{
+	if (bRunning)
+	{
+		return;
+	}
+
+	Options = InOptions;
+	Elapsed = 0.f;
+	bMeasuring = false;
+	bRunning = true;
+
+	if (!IsServer())
+	{
+		return;
+	}
+
+	if (Options.PlayerCounts.Num() > 0)
+	{
+		UE_LOG(LogLocomotion, Log, TEXT("Net soak harness: %d player counts, %.0f s each after %.0f s warmup"), Options.PlayerCounts.Num(), Options.Seconds, Options.WarmupSeconds);
+		CountIndex = 0;
+		LaunchClients(Options.PlayerCounts[0]);
+		return;
+	}
+
+	UE_LOG(LogLocomotion, Log, TEXT("Net soak: %.0f s after %.0f s warmup, %d characters"), Options.Seconds, Options.WarmupSeconds, GetNumCharacters());
+	StartEditorClients();
+}
+
+void ULocomotionNetSoak::StartEditorClients() const
+{
+	if (GetWorld()->WorldType != EWorldType::PIE || !GEngine)
+	{
+		return;
+	}
+
+	// Clients in other processes run Locomotion.NetSoak themselves
+	for (const FWorldContext& Context : GEngine->GetWorldContexts())
+	{
+		UWorld* ClientWorld = Context.World();
+		if (ClientWorld && ClientWorld != GetWorld() && ClientWorld->WorldType == EWorldType::PIE && ClientWorld->GetNetMode() == NM_Client)
+		{
+			if (ULocomotionNetSoak* ClientSoak = ClientWorld->GetSubsystem<ULocomotionNetSoak>())
+			{
+				ClientSoak->Start(Options);
+			}
+		}
+	}
+}
+
+void ULocomotionNetSoak::LaunchClients(int32 Count)
+{
+	// The editor executable needs the project, a packaged client passed with client= knows its own
+	const bool bSameExecutable = Options.ClientExecutable.IsEmpty();
+	const FString Executable = bSameExecutable ? FString(FPlatformProcess::ExecutablePath()) : Options.ClientExecutable;
+	const FString ProjectArg = bSameExecutable && FPaths::IsProjectFilePathSet() ? FString::Printf(TEXT("\"%s\" "), *FPaths::GetProjectFilePath()) : FString();
+
+	// Clients drive their bot until the server closes them, and quit on their own if it never does
+	const int32 ClientSeconds = FMath::CeilToInt(2.f * (Options.ConnectTimeoutSeconds + Options.WarmupSeconds + Options.Seconds));
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FString Args = FString::Printf(TEXT("%s127.0.0.1:%d -game -nullrhi -nosound -nosplash -unattended -log=LocomotionNetSoakClient%d.log -ExecCmds=\"Locomotion.NetSoak seconds=%d warmup=0 exit\""),
+			*ProjectArg, GetWorld()->URL.Port, Index, ClientSeconds);
+
+		FProcHandle Handle = FPlatformProcess::CreateProc(*Executable, *Args, true, true, true, nullptr, 0, nullptr, nullptr);
+		if (Handle.IsValid())
+		{
+			ClientProcesses.Add(Handle);
+		}
+	}
+
+	UE_LOG(LogLocomotion, Log, TEXT("Net soak harness: launched %d of %d headless clients"), ClientProcesses.Num(), Count);
+
+	bWaitingForClients = true;
+	WaitTime = 0.f;
+}
+
+void ULocomotionNetSoak::TerminateClients()
+{
+	for (FProcHandle& Handle : ClientProcesses)
+	{
+		if (FPlatformProcess::IsProcRunning(Handle))
+		{
+			FPlatformProcess::TerminateProc(Handle, true);
+		}
+		FPlatformProcess::CloseProc(Handle);
+	}
+	ClientProcesses.Reset();
+}
+
+void ULocomotionNetSoak::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bRunning)
+	{
+		return;
+	}
+
+	if (bWaitingForClients)
+	{
+		WaitTime += DeltaTime;
+
+		const int32 Target = Options.PlayerCounts[CountIndex];
+		const int32 Connected = GetNumCharacters();
+		if (Connected >= Target || WaitTime >= Options.ConnectTimeoutSeconds)
+		{
+			if (Connected < Target)
+			{
+				UE_LOG(LogLocomotion, Warning, TEXT("Net soak harness: only %d of %d clients connected within %.0f s"), Connected, Target, Options.ConnectTimeoutSeconds);
+			}
+			bWaitingForClients = false;
+			Elapsed = 0.f;
+		}
+		return;
+	}
+
+	const float PreviousTime = Elapsed;
+	Elapsed += DeltaTime;
+	DriveLocalCharacters(PreviousTime, Elapsed);
+
+	if (!bMeasuring && Elapsed >= Options.WarmupSeconds)
+	{
+		BeginMeasure();
+		return;
+	}
+
+	// GGameThreadTime holds the previous frame, so sampling starts one frame into the window
+	if (bMeasuring && IsServer())
+	{
+		FrameMsSum += FPlatformTime::ToMilliseconds(GGameThreadTime);
+		CPUPercentSum += FPlatformTime::GetCPUTime().CPUTimePct;
+		++MeasuredFrames;
+	}
+
+	if (Elapsed >= Options.WarmupSeconds + Options.Seconds)
+	{
+		Finish();
+	}
+}
+
+void ULocomotionNetSoak::DriveLocalCharacters(float PreviousTime, float Time)
+{
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		if (PC && PC->IsLocalController())
+		{
+			// Each client's id spreads the bots over the script phases and headings
+			APlayerCharacter* Character = Cast<APlayerCharacter>(PC->GetPawn());
+			ULocomotionPerfSuite::DriveBot(Character, Character ? static_cast<int32>(Character->GetUniqueID() % 1024) : 0, PreviousTime, Time);
+		}
+	}
+}
+
+void ULocomotionNetSoak::BeginMeasure()
+{
+	bMeasuring = true;
+	if (!IsServer())
+	{
+		return;
+	}
+
+	FLocomotionNetStats::Reset();
+	MeasureStartSeconds = GetWorld()->GetRealTimeSeconds();
+	FrameMsSum = 0.0;
+	CPUPercentSum = 0.0;
+	MeasuredFrames = 0;
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	InBytesAtStart = NetDriver ? NetDriver->InTotalBytes : 0;
+	OutBytesAtStart = NetDriver ? NetDriver->OutTotalBytes : 0;
+}
+
+void ULocomotionNetSoak::Finish()
+{
+	bRunning = false;
+	bMeasuring = false;
+
+	if (!IsServer())
+	{
+		if (Options.bExitWhenDone)
+		{
+			FPlatformMisc::RequestExitWithStatus(false, 0);
+		}
+		return;
+	}
+
+	const UNetDriver* NetDriver = GetWorld()->GetNetDriver();
+	const FLocomotionNetStats::FCounters Counters = FLocomotionNetStats::GetCounters();
+
+	FLocomotionNetSoakResult Result;
+	Result.Characters = GetNumCharacters();
+	Result.Seconds = GetWorld()->GetRealTimeSeconds() - MeasureStartSeconds;
+
+	const double Seconds = FMath::Max(Result.Seconds, 1.0);
+	const double CharacterSeconds = FMath::Max(Result.Characters * Result.Seconds, 1.0);
+	if (NetDriver)
+	{
+		const double OutBytes = static_cast<double>(NetDriver->OutTotalBytes - OutBytesAtStart);
+		Result.InBytesPerCharacterSecond = (NetDriver->InTotalBytes - InBytesAtStart) / CharacterSeconds;
+		Result.OutBytesPerCharacterSecond = OutBytes / CharacterSeconds;
+		Result.OutKBPerSecond = OutBytes / 1024.0 / Seconds;
+	}
+	Result.MovesPerCharacterSecond = Counters.MovesChecked / CharacterSeconds;
+	Result.CorrectionPercent = Counters.MovesChecked > 0 ? 100.0 * Counters.Corrections / Counters.MovesChecked : 0.0;
+	Result.ServerFrameMs = MeasuredFrames > 0 ? FrameMsSum / MeasuredFrames : 0.0;
+	Result.ServerCPUPercent = MeasuredFrames > 0 ? CPUPercentSum / MeasuredFrames : 0.0;
+
+	UE_LOG(LogLocomotion, Log, TEXT("Net soak %d characters over %.1f s: %.1f B/character/s in, %.1f B/character/s out (%.1f KB/s), %.1f moves/character/s, %.2f%% corrected, server %.2f ms/frame at %.1f%% CPU"),
+		Result.Characters, Result.Seconds, Result.InBytesPerCharacterSecond, Result.OutBytesPerCharacterSecond, Result.OutKBPerSecond,
+		Result.MovesPerCharacterSecond, Result.CorrectionPercent, Result.ServerFrameMs, Result.ServerCPUPercent);
+
+	WriteResult(Result);
+
+	if (Options.PlayerCounts.Num() > 0)
+	{
+		TerminateClients();
+
+		++CountIndex;
+		if (CountIndex < Options.PlayerCounts.Num())
+		{
+			bRunning = true;
+			Elapsed = 0.f;
+			LaunchClients(Options.PlayerCounts[CountIndex]);
+			return;
+		}
+	}
+
+	if (Options.bExitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, 0);
+	}
+}
+
+void ULocomotionNetSoak::WriteResult(const FLocomotionNetSoakResult& Result) const
+{
+	// Rows accumulate so runs at different player counts land in one file
+	FString Csv;
+	if (!IFileManager::Get().FileExists(*Options.OutputPath))
+	{
+		Csv += CsvHeader;
+		Csv += LINE_TERMINATOR;
+	}
+	Csv += FString::Printf(TEXT("%d,%.1f,%.1f,%.1f,%.1f,%.2f,%.3f,%.3f,%.1f"), Result.Characters, Result.Seconds, Result.InBytesPerCharacterSecond,
+		Result.OutBytesPerCharacterSecond, Result.OutKBPerSecond, Result.MovesPerCharacterSecond, Result.CorrectionPercent, Result.ServerFrameMs, Result.ServerCPUPercent);
+	Csv += LINE_TERMINATOR;
+
+	if (FFileHelper::SaveStringToFile(Csv, *Options.OutputPath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+	{
+		UE_LOG(LogLocomotion, Log, TEXT("Net soak results appended to %s"), *Options.OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogLocomotion, Warning, TEXT("Could not write net soak results to %s"), *Options.OutputPath);
+	}
+}
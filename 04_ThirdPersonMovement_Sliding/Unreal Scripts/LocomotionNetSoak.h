@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LocomotionNetSoak.generated.h"
+
+// One row of the network soak CSV, averaged over the measured window
+struct FLocomotionNetSoakResult
+{
+	int32 Characters = 0;
+	double Seconds = 0.0;
+	double InBytesPerCharacterSecond = 0.0;
+	double OutBytesPerCharacterSecond = 0.0;
+	double OutKBPerSecond = 0.0;
+	double MovesPerCharacterSecond = 0.0;
+	double CorrectionPercent = 0.0;
+	double ServerFrameMs = 0.0;
+	double ServerCPUPercent = 0.0;
+};
+
+/**
+ * Network soak for the locomotion prediction. Every client drives its own character with the perf suite bot script,
+ * and the server measures the bytes its net driver receives and sends, its frame time and CPU use, and the share of
+ * client moves it had to correct. Results are appended to Saved/Locomotion/NetSoak.csv.
+ *
+ * Play in editor with several clients (Net Mode "Play As Listen Server" or "Play As Client"), then in any PIE console:
+ * Locomotion.NetSoak [seconds=N] [warmup=N] [out=File] [exit]
+ * The server starts the bots on every client world in the editor process.
+ *
+ * On a dedicated server, players=64,128 launches that many headless clients per row and waits for them to connect:
+ * -server -nullrhi -ExecCmds="Locomotion.NetSoak players=64,128 exit"
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ULocomotionNetSoak : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	struct FOptions
+	{
+		float Seconds = 60.f;
+		float WarmupSeconds = 5.f;
+		FString OutputPath;
+		bool bExitWhenDone = false;
+
+		// Headless client counts, one row each. Empty measures whoever is connected
+		TArray<int32> PlayerCounts;
+		// Defaults to this executable with the current project
+		FString ClientExecutable;
+		float ConnectTimeoutSeconds = 180.f;
+	};
+
+	// On a server measures and drives local characters, on a client only drives them
+	void Start(const FOptions& InOptions);
+	bool IsRunning() const { return bRunning; }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+private:
+	bool IsServer() const;
+	int32 GetNumCharacters() const;
+	void StartEditorClients() const;
+	void DriveLocalCharacters(float PreviousTime, float Time);
+
+	void LaunchClients(int32 Count);
+	void TerminateClients();
+
+	void BeginMeasure();
+	void Finish();
+	void WriteResult(const FLocomotionNetSoakResult& Result) const;
+
+	FOptions Options;
+	bool bRunning = false;
+	bool bMeasuring = false;
+	float Elapsed = 0.f;
+
+	// Harness progress through Options.PlayerCounts
+	int32 CountIndex = 0;
+	bool bWaitingForClients = false;
+	float WaitTime = 0.f;
+	TArray<FProcHandle> ClientProcesses;
+
+	uint64 InBytesAtStart = 0;
+	uint64 OutBytesAtStart = 0;
+	double MeasureStartSeconds = 0.0;
+	double FrameMsSum = 0.0;
+	double CPUPercentSum = 0.0;
+	int32 MeasuredFrames = 0;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/Interface.h"
+#include "LocomotionNotifyReceiver.generated.h"
+
+// Anim notify events, drained in this order when several arrive in the same frame
+UENUM(BlueprintType)
+enum class ELocomotionNotifyEvent : uint8
+{
+	ApplyJumpForce,
+	TriggerFlip,
+	EndFlip,
+	StartProneTransition,
+	EndProneTransition,
+	Num UMETA(Hidden)
+};
+
+static_assert(static_cast<uint32>(ELocomotionNotifyEvent::Num) <= 32, "Pending notify events are stored as a 32-bit mask");
+
+UINTERFACE(meta = (CannotImplementInterfaceInBlueprint))
+class ULocomotionNotifyReceiver : public UInterface
+{
+	GENERATED_BODY()
+};
+
+/**
+ * Receives the events queued by UAnimNotify_Locomotion. Register the mesh that plays the notifies
+ * with ULocomotionSubsystem::RegisterNotifyReceiver, events are handed over once per frame.
+ */
+class MECHANICS_TEST_LVN_API ILocomotionNotifyReceiver
+{
+	GENERATED_BODY()
+
+public:
+	virtual void HandleLocomotionNotify(ELocomotionNotifyEvent Event) = 0;
+};
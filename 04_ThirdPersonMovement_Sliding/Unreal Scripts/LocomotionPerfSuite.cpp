@@ -0,0 +1,504 @@
+#include "LocomotionPerfSuite.h"
+#include "PlayerCharacter.h"
+#include "LocomotionGroundInfo.h"
+#include "LocomotionSubsystem.h"
+#include "LocomotionUtils.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformMemory.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "RenderCore.h"
+
+namespace
+{
+	constexpr int32 WarmupFrames = 60;
+
+	// Arena layout, the arena floats above the level so it never overlaps level geometry
+	const FVector ArenaOrigin(0.f, 0.f, 20000.f);
+	constexpr float TileSize = 2400.f;
+	constexpr float BotSpacing = 150.f;
+	constexpr float BotSpawnHeight = 450.f;
+	constexpr float CeilingHeight = 120.f;
+	constexpr float PlatformHeight = 300.f;
+	constexpr float WallHeight = 400.f;
+	constexpr float RampAngles[] = { 0.f, 15.f, 30.f, 45.f };
+
+	// One bot cycle: sprint, slide, double jump, then crouch, prone and back up
+	struct FBotStep
+	{
+		float Time;
+		ELocomotionInputEvent Event;
+	};
+
+	constexpr FBotStep BotScript[] =
+	{
+		{ 0.0f, ELocomotionInputEvent::RunPressed },
+		{ 1.0f, ELocomotionInputEvent::CrouchPressed },
+		{ 1.8f, ELocomotionInputEvent::CrouchReleased },
+		{ 2.5f, ELocomotionInputEvent::Jump },
+		{ 2.8f, ELocomotionInputEvent::Jump },
+		{ 4.0f, ELocomotionInputEvent::RunReleased },
+		{ 4.5f, ELocomotionInputEvent::CrouchPressed },
+		{ 5.0f, ELocomotionInputEvent::Prone },
+		{ 6.0f, ELocomotionInputEvent::Prone },
+		{ 6.5f, ELocomotionInputEvent::CrouchPressed },
+	};
+	constexpr float BotScriptLength = 7.5f;
+
+	// Metrics checked against the baseline, all of them are worse when higher
+	struct FPerfMetric
+	{
+		const TCHAR* Name;
+		double FLocomotionPerfResult::* Value;
+	};
+
+	const FPerfMetric PerfMetrics[] =
+	{
+		{ TEXT("GameThreadMs"), &FLocomotionPerfResult::GameThreadMs },
+		{ TEXT("LocomotionMs"), &FLocomotionPerfResult::LocomotionMs },
+		{ TEXT("TracesPerCharacterFrame"), &FLocomotionPerfResult::TracesPerCharacterFrame },
+		{ TEXT("SweepsPerCharacterFrame"), &FLocomotionPerfResult::SweepsPerCharacterFrame },
+		{ TEXT("MemoryKBPerCharacter"), &FLocomotionPerfResult::MemoryKBPerCharacter },
+	};
+
+	const TCHAR* CsvHeader = TEXT("Characters,GameThreadMs,LocomotionMs,TracesPerCharacterFrame,SweepsPerCharacterFrame,MemoryKBPerCharacter");
+
+	bool LoadResults(const FString& Filename, TArray<FLocomotionPerfResult>& OutResults)
+	{
+		TArray<FString> Lines;
+		if (!FFileHelper::LoadFileToStringArray(Lines, *Filename))
+		{
+			return false;
+		}
+
+		for (const FString& Line : Lines)
+		{
+			TArray<FString> Columns;
+			Line.ParseIntoArray(Columns, TEXT(","));
+			if (Columns.Num() != UE_ARRAY_COUNT(PerfMetrics) + 1 || !Columns[0].IsNumeric())
+			{
+				continue;
+			}
+
+			FLocomotionPerfResult& Result = OutResults.AddDefaulted_GetRef();
+			Result.Characters = FCString::Atoi(*Columns[0]);
+			for (int32 Index = 0; Index < UE_ARRAY_COUNT(PerfMetrics); ++Index)
+			{
+				Result.*PerfMetrics[Index].Value = FCString::Atod(*Columns[Index + 1]);
+			}
+		}
+
+		// A file without a single result row is no baseline
+		return OutResults.Num() > 0;
+	}
+}
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionPerfSuite(
+	TEXT("Locomotion.PerfSuite"),
+	TEXT("Locomotion.PerfSuite [Count...] [frames=N] [baseline=File] [out=File] [tolerance=Percent] [exit] - Runs scripted bots on a generated slope arena (default 1 100 1000 5000 characters), ")
+	TEXT("writes the metrics to CSV and fails when a metric is worse than the baseline by more than the tolerance."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		ULocomotionPerfSuite* Suite = World ? World->GetSubsystem<ULocomotionPerfSuite>() : nullptr;
+		if (!Suite || Suite->IsRunning())
+		{
+			return;
+		}
+
+		ULocomotionPerfSuite::FOptions Options;
+		Options.OutputPath = FPaths::ProjectSavedDir() / TEXT("Locomotion") / TEXT("PerfSuite.csv");
+
+		for (const FString& Arg : Args)
+		{
+			FString Key;
+			FString Value;
+			if (!Arg.Split(TEXT("="), &Key, &Value))
+			{
+				if (Arg == TEXT("exit"))
+				{
+					Options.bExitWhenDone = true;
+				}
+				else if (Arg.IsNumeric())
+				{
+					Options.CharacterCounts.Add(FMath::Max(FCString::Atoi(*Arg), 1));
+				}
+				continue;
+			}
+
+			if (Key == TEXT("frames"))
+			{
+				Options.FramesPerCount = FMath::Max(FCString::Atoi(*Value), 1);
+			}
+			else if (Key == TEXT("baseline"))
+			{
+				Options.BaselinePath = LocomotionUtils::ResolvePath(Value, FPaths::ProjectDir());
+			}
+			else if (Key == TEXT("out"))
+			{
+				Options.OutputPath = LocomotionUtils::ResolvePath(Value, FPaths::ProjectSavedDir() / TEXT("Locomotion"));
+			}
+			else if (Key == TEXT("tolerance"))
+			{
+				Options.TolerancePercent = FCString::Atof(*Value);
+			}
+		}
+
+		if (Options.CharacterCounts.Num() == 0)
+		{
+			Options.CharacterCounts = { 1, 100, 1000, 5000 };
+		}
+
+		Suite->Start(Options);
+	}));
+
+bool ULocomotionPerfSuite::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId ULocomotionPerfSuite::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(ULocomotionPerfSuite, STATGROUP_Tickables);
+}
+
+void ULocomotionPerfSuite::Deinitialize()
+{
+	// The world is going away with the arena and bots in it
+	bRunning = false;
+	ArenaActors.Reset();
+	ArenaMesh = nullptr;
+	Bots.Reset();
+
+	Super::Deinitialize();
+}
+
+void ULocomotionPerfSuite::Start(const FOptions& InOptions)
+{
+	if (bRunning || InOptions.CharacterCounts.Num() == 0)
+	{
+		return;
+	}
+
+	Options = InOptions;
+	Results.Reset();
+	CountIndex = 0;
+	bRunning = true;
+
+	BuildArena(FMath::Max(Options.CharacterCounts));
+
+	UE_LOG(LogLocomotion, Log, TEXT("Perf suite: %d counts, %d frames each, tolerance %.1f%%"), Options.CharacterCounts.Num(), Options.FramesPerCount, Options.TolerancePercent);
+
+	SpawnBots(Options.CharacterCounts[0]);
+}
+
+void ULocomotionPerfSuite::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (!bRunning)
+	{
+		return;
+	}
+
+	DriveBots(DeltaTime);
+
+	++Frame;
+	if (Frame == WarmupFrames)
+	{
+		FLocomotionGroundInfoStats::Reset();
+		GameThreadMsSum = 0.0;
+		LocomotionMsSum = 0.0;
+		return;
+	}
+
+	if (Frame < WarmupFrames)
+	{
+		return;
+	}
+
+	// GGameThreadTime holds the previous frame, the warmup frames absorb the spawn
+	GameThreadMsSum += FPlatformTime::ToMilliseconds(GGameThreadTime);
+	if (const ULocomotionSubsystem* Subsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+	{
+		LocomotionMsSum += Subsystem->IsBatchTicking() ? Subsystem->GetLastBatchTickMs() : 0.0;
+	}
+
+	if (Frame >= WarmupFrames + Options.FramesPerCount)
+	{
+		FinishCount();
+	}
+}
+
+void ULocomotionPerfSuite::BuildArena(int32 MaxCharacters)
+{
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(MaxCharacters)));
+	const int32 Tiles = FMath::Max(FMath::CeilToInt(Columns * BotSpacing / TileSize), 2);
+	const float Extent = Tiles * TileSize;
+
+	ArenaMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+
+	const float Half = Extent * 0.5f;
+
+	// Floor and walls keep the bots inside
+	AddArenaBox(FVector(Half, Half, -10.f), FVector(Extent, Extent, 20.f));
+	AddArenaBox(FVector(Half, -10.f, WallHeight * 0.5f), FVector(Extent, 20.f, WallHeight));
+	AddArenaBox(FVector(Half, Extent + 10.f, WallHeight * 0.5f), FVector(Extent, 20.f, WallHeight));
+	AddArenaBox(FVector(-10.f, Half, WallHeight * 0.5f), FVector(20.f, Extent, WallHeight));
+	AddArenaBox(FVector(Extent + 10.f, Half, WallHeight * 0.5f), FVector(20.f, Extent, WallHeight));
+
+	for (int32 TileY = 0; TileY < Tiles; ++TileY)
+	{
+		for (int32 TileX = 0; TileX < Tiles; ++TileX)
+		{
+			const FVector Corner(TileX * TileSize, TileY * TileSize, 0.f);
+
+			// Ramp with its low edge on the floor
+			constexpr float RampLength = 800.f;
+			const float Angle = RampAngles[(TileX + TileY) % UE_ARRAY_COUNT(RampAngles)];
+			const float Radians = FMath::DegreesToRadians(Angle);
+			AddArenaBox(Corner + FVector(200.f + 0.5f * RampLength * FMath::Cos(Radians), 400.f, 0.5f * RampLength * FMath::Sin(Radians)),
+				FVector(RampLength, 500.f, 20.f), FRotator(Angle, 0.f, 0.f));
+
+			// Low ceiling, only crouch and prone fit underneath
+			AddArenaBox(Corner + FVector(1600.f, 400.f, CeilingHeight + 10.f), FVector(600.f, 500.f, 20.f));
+
+			// Platform with drop-offs on every side
+			AddArenaBox(Corner + FVector(1200.f, 1700.f, PlatformHeight * 0.5f), FVector(800.f, 800.f, PlatformHeight));
+		}
+	}
+
+	UE_LOG(LogLocomotion, Log, TEXT("Perf suite arena: %dx%d tiles, %.0f units across, %d actors"), Tiles, Tiles, Extent, ArenaActors.Num());
+}
+
+void ULocomotionPerfSuite::AddArenaBox(const FVector& Center, const FVector& Size, const FRotator& Rotation)
+{
+	if (!ArenaMesh)
+	{
+		return;
+	}
+
+	// The engine cube is 100 units across
+	const FTransform Transform(Rotation, ArenaOrigin + Center, Size / 100.f);
+	if (AStaticMeshActor* Box = GetWorld()->SpawnActor<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform))
+	{
+		UStaticMeshComponent* Mesh = Box->GetStaticMeshComponent();
+		Mesh->SetMobility(EComponentMobility::Movable);
+		Mesh->SetStaticMesh(ArenaMesh);
+		ArenaActors.Add(Box);
+	}
+}
+
+void ULocomotionPerfSuite::DestroyArena()
+{
+	for (AActor* Actor : ArenaActors)
+	{
+		if (IsValid(Actor))
+		{
+			Actor->Destroy();
+		}
+	}
+	ArenaActors.Reset();
+	ArenaMesh = nullptr;
+}
+
+void ULocomotionPerfSuite::SpawnBots(int32 Count)
+{
+	UWorld* World = GetWorld();
+
+	const TSubclassOf<APlayerCharacter> CharacterClass = LocomotionUtils::GetDefaultCharacterClass(World);
+
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	const uint64 UsedPhysicalBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	Bots.Reserve(Count);
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Location = ArenaOrigin + FVector(BotSpacing * (0.5f + Index % Columns), BotSpacing * (0.5f + Index / Columns), BotSpawnHeight);
+		const FRotator Rotation(0.f, FMath::Fmod(Index * 137.5f, 360.f), 0.f);
+		if (APlayerCharacter* Character = World->SpawnActor<APlayerCharacter>(CharacterClass, Location, Rotation, Params))
+		{
+			// Move input needs a controller, the camera basis follows its control rotation
+			Character->SpawnDefaultController();
+			if (Character->Controller)
+			{
+				Character->Controller->SetControlRotation(Rotation);
+			}
+			Bots.Add(Character);
+		}
+	}
+
+	const uint64 UsedPhysicalAfter = FPlatformMemory::GetStats().UsedPhysical;
+	MemoryKBPerCharacter = Bots.Num() > 0 && UsedPhysicalAfter > UsedPhysicalBefore ? (UsedPhysicalAfter - UsedPhysicalBefore) / 1024.0 / Bots.Num() : 0.0;
+
+	Frame = 0;
+	BotTime = 0.f;
+}
+
+void ULocomotionPerfSuite::DestroyBots()
+{
+	for (APlayerCharacter* Character : Bots)
+	{
+		if (!IsValid(Character))
+		{
+			continue;
+		}
+
+		if (AController* BotController = Character->Controller)
+		{
+			BotController->Destroy();
+		}
+		Character->Destroy();
+	}
+	Bots.Reset();
+}
+
+void ULocomotionPerfSuite::DriveBots(float DeltaTime)
+{
+	const float PreviousTime = BotTime;
+	BotTime += DeltaTime;
+
+	for (int32 Index = 0; Index < Bots.Num(); ++Index)
+	{
+		DriveBot(Bots[Index], Index, PreviousTime, BotTime);
+	}
+}
+
+void ULocomotionPerfSuite::DriveBot(APlayerCharacter* Character, int32 Index, float PreviousTime, float Time)
+{
+	if (!IsValid(Character) || !Character->Controller)
+	{
+		return;
+	}
+
+	// Bots run the script out of phase and weave, so every ramp, ceiling and edge gets visited
+	const float Phase = FMath::Frac(Index * 0.618034f) * BotScriptLength;
+	const float Previous = FMath::Fmod(PreviousTime + Phase, BotScriptLength);
+	const float Current = FMath::Fmod(Time + Phase, BotScriptLength);
+
+	FRotator ControlRotation = Character->Controller->GetControlRotation();
+	ControlRotation.Yaw = FMath::Fmod(Index * 137.5f, 360.f) + 40.f * FMath::Sin(0.5f * Time + Phase);
+	Character->Controller->SetControlRotation(ControlRotation);
+
+	Character->DispatchInputEvent(ELocomotionInputEvent::Move, FVector2D(0.f, 1.f));
+
+	for (const FBotStep& Step : BotScript)
+	{
+		const bool bFires = Previous <= Current ? Step.Time > Previous && Step.Time <= Current : Step.Time > Previous || Step.Time <= Current;
+		if (bFires)
+		{
+			Character->DispatchInputEvent(Step.Event, FVector2D::ZeroVector);
+		}
+	}
+}
+
+void ULocomotionPerfSuite::FinishCount()
+{
+	const FLocomotionGroundInfoStats::FCounters Counters = FLocomotionGroundInfoStats::GetCounters();
+	const double CharacterFrames = Counters.CharacterFrames > 0 ? static_cast<double>(Counters.CharacterFrames) : 1.0;
+
+	FLocomotionPerfResult& Result = Results.AddDefaulted_GetRef();
+	Result.Characters = Options.CharacterCounts[CountIndex];
+	Result.GameThreadMs = GameThreadMsSum / Options.FramesPerCount;
+	Result.LocomotionMs = LocomotionMsSum / Options.FramesPerCount;
+	Result.TracesPerCharacterFrame = (Counters.Traces + Counters.AsyncTraces) / CharacterFrames;
+	Result.SweepsPerCharacterFrame = Counters.ClearanceSweeps / CharacterFrames;
+	Result.MemoryKBPerCharacter = MemoryKBPerCharacter;
+
+	UE_LOG(LogLocomotion, Log, TEXT("Perf suite %5d characters: game thread %.3f ms, locomotion %.3f ms, %.3f traces and %.3f sweeps/character/frame, %.1f KB/character"),
+		Result.Characters, Result.GameThreadMs, Result.LocomotionMs, Result.TracesPerCharacterFrame, Result.SweepsPerCharacterFrame, Result.MemoryKBPerCharacter);
+
+	DestroyBots();
+
+	++CountIndex;
+	if (CountIndex >= Options.CharacterCounts.Num())
+	{
+		Finish();
+		return;
+	}
+
+	SpawnBots(Options.CharacterCounts[CountIndex]);
+}
+
+void ULocomotionPerfSuite::Finish()
+{
+	bRunning = false;
+	DestroyArena();
+
+	FString Csv = CsvHeader;
+	Csv += LINE_TERMINATOR;
+	for (const FLocomotionPerfResult& Result : Results)
+	{
+		Csv += FString::Printf(TEXT("%d,%.4f,%.4f,%.4f,%.4f,%.2f"), Result.Characters, Result.GameThreadMs, Result.LocomotionMs,
+			Result.TracesPerCharacterFrame, Result.SweepsPerCharacterFrame, Result.MemoryKBPerCharacter);
+		Csv += LINE_TERMINATOR;
+	}
+
+	if (FFileHelper::SaveStringToFile(Csv, *Options.OutputPath))
+	{
+		UE_LOG(LogLocomotion, Log, TEXT("Perf suite results written to %s"), *Options.OutputPath);
+	}
+	else
+	{
+		UE_LOG(LogLocomotion, Warning, TEXT("Could not write perf suite results to %s"), *Options.OutputPath);
+	}
+
+	const bool bPassed = CompareWithBaseline();
+
+	if (Options.bExitWhenDone)
+	{
+		FPlatformMisc::RequestExitWithStatus(false, bPassed ? 0 : 1);
+	}
+}
+
+bool ULocomotionPerfSuite::CompareWithBaseline() const
+{
+	if (Options.BaselinePath.IsEmpty())
+	{
+		return true;
+	}
+
+	// A baseline was asked for, a missing or unreadable one must not pass the gate silently
+	TArray<FLocomotionPerfResult> Baseline;
+	if (!LoadResults(Options.BaselinePath, Baseline))
+	{
+		UE_LOG(LogLocomotion, Error, TEXT("Could not load the perf baseline %s, copy %s there to start tracking regressions"), *Options.BaselinePath, *Options.OutputPath);
+		return false;
+	}
+
+	// Small absolute slack so metrics that are near zero in the baseline do not fail on noise
+	constexpr double AbsoluteSlack = 0.001;
+	const double Scale = 1.0 + Options.TolerancePercent / 100.0;
+
+	bool bPassed = true;
+	for (const FLocomotionPerfResult& Result : Results)
+	{
+		const FLocomotionPerfResult* Expected = Baseline.FindByPredicate([&Result](const FLocomotionPerfResult& Row) { return Row.Characters == Result.Characters; });
+		if (!Expected)
+		{
+			UE_LOG(LogLocomotion, Warning, TEXT("Perf baseline has no row for %d characters"), Result.Characters);
+			continue;
+		}
+
+		for (const FPerfMetric& Metric : PerfMetrics)
+		{
+			const double Value = Result.*Metric.Value;
+			const double Limit = Expected->*Metric.Value * Scale + AbsoluteSlack;
+			if (Value > Limit)
+			{
+				UE_LOG(LogLocomotion, Error, TEXT("Perf regression at %d characters: %s %.4f, baseline %.4f (+%.1f%% allowed)"),
+					Result.Characters, Metric.Name, Value, Expected->*Metric.Value, Options.TolerancePercent);
+				bPassed = false;
+			}
+		}
+	}
+
+	UE_LOG(LogLocomotion, Log, TEXT("Perf suite %s against %s"), bPassed ? TEXT("passed") : TEXT("FAILED"), *Options.BaselinePath);
+	return bPassed;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LocomotionPerfSuite.generated.h"
+
+class AActor;
+class APlayerCharacter;
+class UStaticMesh;
+
+// One row of the performance suite CSV, averaged over the measured frames of one character count
+struct FLocomotionPerfResult
+{
+	int32 Characters = 0;
+	double GameThreadMs = 0.0;
+	double LocomotionMs = 0.0;
+	double TracesPerCharacterFrame = 0.0;
+	double SweepsPerCharacterFrame = 0.0;
+	double MemoryKBPerCharacter = 0.0;
+};
+
+/**
+ * Headless performance suite. Builds a slope arena (0-45 degree ramps, low ceilings, drop-off platforms),
+ * spawns each character count with scripted bots that sprint, slide, jump, crouch and go prone,
+ * and writes game thread time, trace counts and memory per character to CSV.
+ * Rows are compared against a baseline CSV, a metric worse by more than the tolerance fails the run.
+ *
+ * -game -nullrhi -ExecCmds="Locomotion.PerfSuite baseline=Config/LocomotionPerfBaseline.csv exit"
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ULocomotionPerfSuite : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	struct FOptions
+	{
+		TArray<int32> CharacterCounts;
+		int32 FramesPerCount = 600;
+		FString OutputPath;
+		FString BaselinePath;
+		float TolerancePercent = 10.f;
+		bool bExitWhenDone = false;
+	};
+
+	void Start(const FOptions& InOptions);
+	bool IsRunning() const { return bRunning; }
+
+	// One bot's scripted input between PreviousTime and Time, Index picks its phase and heading
+	static void DriveBot(APlayerCharacter* Character, int32 Index, float PreviousTime, float Time);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Deinitialize() override;
+
+private:
+	void BuildArena(int32 MaxCharacters);
+	void AddArenaBox(const FVector& Center, const FVector& Size, const FRotator& Rotation = FRotator::ZeroRotator);
+	void DestroyArena();
+
+	void SpawnBots(int32 Count);
+	void DestroyBots();
+	void DriveBots(float DeltaTime);
+
+	void FinishCount();
+	void Finish();
+	bool CompareWithBaseline() const;
+
+	FOptions Options;
+	bool bRunning = false;
+
+	int32 CountIndex = 0;
+	int32 Frame = 0;
+	float BotTime = 0.f;
+
+	// Sums over the measured frames of the current count
+	double GameThreadMsSum = 0.0;
+	double LocomotionMsSum = 0.0;
+	double MemoryKBPerCharacter = 0.0;
+
+	TArray<FLocomotionPerfResult> Results;
+
+	UPROPERTY()
+	TObjectPtr<UStaticMesh> ArenaMesh;
+
+	UPROPERTY()
+	TArray<TObjectPtr<AActor>> ArenaActors;
+
+	UPROPERTY()
+	TArray<TObjectPtr<APlayerCharacter>> Bots;
+};
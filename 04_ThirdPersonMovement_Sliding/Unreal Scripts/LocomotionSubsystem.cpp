@@ -0,0 +1,673 @@
+#include "LocomotionSubsystem.h"
+#include "PlayerCharacter.h"
+#include "LocomotionDebug.h"
+#include "LocomotionUtils.h"
+#include "Async/ParallelFor.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "RenderCore.h"
+#include "SignificanceManager.h"
+
+DEFINE_LOG_CATEGORY(LogLocomotion);
+
+DECLARE_STATS_GROUP(TEXT("Locomotion"), STATGROUP_Locomotion, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Batch Tick"), STAT_LocomotionBatchTick, STATGROUP_Locomotion);
+DECLARE_CYCLE_STAT(TEXT("Batch Gather"), STAT_LocomotionBatchGather, STATGROUP_Locomotion);
+DECLARE_CYCLE_STAT(TEXT("Batch Rules"), STAT_LocomotionBatchRules, STATGROUP_Locomotion);
+DECLARE_CYCLE_STAT(TEXT("Batch Apply"), STAT_LocomotionBatchApply, STATGROUP_Locomotion);
+
+static TAutoConsoleVariable<bool> CVarLocomotionBatchTick(
+	TEXT("Locomotion.BatchTick"),
+	true,
+	TEXT("Tick every APlayerCharacter from ULocomotionSubsystem in one pass instead of per-actor ticks."));
+
+static TAutoConsoleVariable<int32> CVarLocomotionParallelThreshold(
+	TEXT("Locomotion.BatchTickParallelThreshold"),
+	64,
+	TEXT("Minimum number of characters before the locomotion rules run in a ParallelFor."));
+
+static TAutoConsoleVariable<bool> CVarLocomotionTickLOD(
+	TEXT("Locomotion.TickLOD"),
+	true,
+	TEXT("Drop the locomotion and movement tick of far or off-screen characters to Locomotion.TickLOD.VisibleRate / HiddenRate."));
+
+static TAutoConsoleVariable<float> CVarLocomotionTickLODNearDistance(
+	TEXT("Locomotion.TickLOD.NearDistance"),
+	2000.f,
+	TEXT("Characters closer than this to a player viewpoint always tick every frame."));
+
+static TAutoConsoleVariable<float> CVarLocomotionTickLODFarDistance(
+	TEXT("Locomotion.TickLOD.FarDistance"),
+	6000.f,
+	TEXT("Visible characters further than this tick at the hidden rate."));
+
+static TAutoConsoleVariable<float> CVarLocomotionTickLODVisibleRate(
+	TEXT("Locomotion.TickLOD.VisibleRate"),
+	20.f,
+	TEXT("Tick rate in Hz of visible characters between the near and far distance."));
+
+static TAutoConsoleVariable<float> CVarLocomotionTickLODHiddenRate(
+	TEXT("Locomotion.TickLOD.HiddenRate"),
+	10.f,
+	TEXT("Tick rate in Hz of off-screen characters and characters past the far distance."));
+
+static TAutoConsoleVariable<bool> CVarLocomotionTickLODUpdateSignificance(
+	TEXT("Locomotion.TickLOD.UpdateSignificance"),
+	false,
+	TEXT("Let ULocomotionSubsystem call USignificanceManager::Update with the player viewpoints every frame. ")
+	TEXT("Leave off when the game already updates the significance manager, the subsystem then only registers characters and reads the results."));
+
+static TAutoConsoleVariable<bool> CVarLocomotionDormancy(
+	TEXT("Locomotion.Dormancy"),
+	true,
+	TEXT("Stop ticking idle characters until an input event, anim notify or movement mode change wakes them."));
+
+static TAutoConsoleVariable<float> CVarLocomotionDormancyIdleGrace(
+	TEXT("Locomotion.Dormancy.IdleGrace"),
+	0.25f,
+	TEXT("Seconds a character has to stay idle before it goes dormant, so stopping between two key presses does not put it to sleep."));
+
+static const FName LocomotionSignificanceTag(TEXT("Locomotion"));
+
+static FAutoConsoleCommandWithWorldAndArgs CmdLocomotionCompareTickModes(
+	TEXT("Locomotion.CompareTickModes"),
+	TEXT("Locomotion.CompareTickModes [FramesPerMode] [Count...] - Spawns characters (default 100 1000 10000) and logs per-actor vs batched tick cost."),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		ULocomotionSubsystem* Subsystem = World ? World->GetSubsystem<ULocomotionSubsystem>() : nullptr;
+		if (!Subsystem)
+		{
+			return;
+		}
+
+		const int32 FramesPerMode = Args.Num() > 0 ? FCString::Atoi(*Args[0]) : 300;
+
+		TArray<int32> Counts;
+		for (int32 Index = 1; Index < Args.Num(); ++Index)
+		{
+			Counts.Add(FCString::Atoi(*Args[Index]));
+		}
+		if (Counts.Num() == 0)
+		{
+			Counts = { 100, 1000, 10000 };
+		}
+
+		Subsystem->StartTickComparison(Counts, FMath::Max(FramesPerMode, 1));
+	}));
+
+void FLocomotionBatchTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->TickCharacters(DeltaTime);
+	}
+}
+
+FString FLocomotionBatchTickFunction::DiagnosticMessage()
+{
+	return TEXT("FLocomotionBatchTickFunction");
+}
+
+bool ULocomotionSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void ULocomotionSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	bBatchTicking = CVarLocomotionBatchTick.GetValueOnGameThread();
+
+	BatchTickFunction.Subsystem = this;
+	BatchTickFunction.bCanEverTick = true;
+	BatchTickFunction.bStartWithTickEnabled = true;
+	BatchTickFunction.TickGroup = TG_PrePhysics;
+	BatchTickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+
+	PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &ULocomotionSubsystem::OnWorldPostActorTick);
+}
+
+void ULocomotionSubsystem::Deinitialize()
+{
+	if (BatchTickFunction.IsTickFunctionRegistered())
+	{
+		BatchTickFunction.UnRegisterTickFunction();
+	}
+	BatchTickFunction.Subsystem = nullptr;
+	FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+	PostActorTickHandle.Reset();
+	EndTickComparison();
+	DormantCharacters.Reset();
+	PendingDormant.Reset();
+	PassCharacters.Reset();
+	NotifyQueues.Reset();
+	PendingNotifyMeshes.Reset();
+#if LOCOMOTION_DEBUG
+	FLocomotionDebugBuffer::Release(GetWorld());
+#endif
+	Characters.Reset();
+
+	Super::Deinitialize();
+}
+
+void ULocomotionSubsystem::RegisterCharacter(APlayerCharacter* Character)
+{
+	if (!Character || Characters.Contains(Character) || DormantCharacters.Contains(Character))
+	{
+		return;
+	}
+
+	Characters.Add(Character);
+	SetCharacterBatched(Character, bBatchTicking);
+	RegisterNotifyReceiver(Character->GetMesh(), Character);
+
+	if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+	{
+		SignificanceManager->RegisterObject(Character, LocomotionSignificanceTag,
+			[](USignificanceManager::FManagedObjectInfo* Info, const FTransform& Viewpoint)
+			{
+				return CalculateSignificance(CastChecked<APlayerCharacter>(Info->GetObject()), Viewpoint);
+			},
+			USignificanceManager::EPostSignificanceType::Sequential,
+			[](USignificanceManager::FManagedObjectInfo* Info, float OldSignificance, float Significance, bool bFinal)
+			{
+				CastChecked<APlayerCharacter>(Info->GetObject())->SetLocomotionTickInterval(GetTickIntervalForSignificance(Significance));
+			});
+	}
+}
+
+void ULocomotionSubsystem::UnregisterCharacter(APlayerCharacter* Character)
+{
+	if (Characters.RemoveSingleSwap(Character) > 0 || DormantCharacters.RemoveSingleSwap(Character) > 0)
+	{
+		const int32 PassIndex = PassCharacters.IndexOfByKey(Character);
+		if (PassIndex != INDEX_NONE)
+		{
+			PassCharacters[PassIndex] = nullptr;
+		}
+
+		Character->bLocomotionDormant = false;
+		SetCharacterBatched(Character, false);
+		UnregisterNotifyReceiver(Character->GetMesh());
+
+		if (USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld()))
+		{
+			SignificanceManager->UnregisterObject(Character);
+		}
+	}
+}
+
+float ULocomotionSubsystem::CalculateSignificance(const APlayerCharacter* Character, const FTransform& Viewpoint)
+{
+	if (!CVarLocomotionTickLOD.GetValueOnGameThread() || Character->IsPlayerControlled())
+	{
+		return 1.f;
+	}
+
+	// Slides and jumps integrate fast changing state, they stay at full rate until they end
+	if (Character->IsSliding() || Character->IsJumping() || Character->IsFlipping() || Character->GetCharacterMovement()->IsFalling())
+	{
+		return 1.f;
+	}
+
+	const double DistanceSquared = FVector::DistSquared(Viewpoint.GetLocation(), Character->GetActorLocation());
+	if (DistanceSquared <= FMath::Square(CVarLocomotionTickLODNearDistance.GetValueOnGameThread()))
+	{
+		return 1.f;
+	}
+
+	const bool bVisible = Character->WasRecentlyRendered(0.25f);
+	return bVisible && DistanceSquared <= FMath::Square(CVarLocomotionTickLODFarDistance.GetValueOnGameThread()) ? 0.5f : 0.f;
+}
+
+float ULocomotionSubsystem::GetTickIntervalForSignificance(float Significance)
+{
+	if (Significance >= 1.f)
+	{
+		return 0.f;
+	}
+
+	const float Rate = Significance >= 0.5f ? CVarLocomotionTickLODVisibleRate.GetValueOnGameThread() : CVarLocomotionTickLODHiddenRate.GetValueOnGameThread();
+	return Rate > 0.f ? 1.f / Rate : 0.f;
+}
+
+void ULocomotionSubsystem::UpdateSignificance()
+{
+	// The game owns the significance update unless it hands it to this subsystem
+	if (!CVarLocomotionTickLODUpdateSignificance.GetValueOnGameThread())
+	{
+		return;
+	}
+
+	USignificanceManager* SignificanceManager = USignificanceManager::Get(GetWorld());
+	if (!SignificanceManager || Characters.Num() == 0)
+	{
+		return;
+	}
+
+	// Every player's view counts, the manager keeps the highest significance per character
+	Viewpoints.Reset();
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (const APlayerController* PC = It->Get())
+		{
+			FVector Location;
+			FRotator Rotation;
+			PC->GetPlayerViewPoint(Location, Rotation);
+			Viewpoints.Emplace(Rotation, Location);
+		}
+	}
+
+	SignificanceManager->Update(Viewpoints);
+}
+
+void ULocomotionSubsystem::SetBatchTicking(bool bEnabled)
+{
+	bBatchTicking = bEnabled;
+	for (APlayerCharacter* Character : Characters)
+	{
+		SetCharacterBatched(Character, bEnabled);
+	}
+	for (APlayerCharacter* Character : DormantCharacters)
+	{
+		SetCharacterBatched(Character, bEnabled);
+	}
+}
+
+void ULocomotionSubsystem::RegisterNotifyReceiver(const USkeletalMeshComponent* Mesh, ILocomotionNotifyReceiver* Receiver)
+{
+	if (Mesh && Receiver)
+	{
+		NotifyQueues.FindOrAdd(Mesh).Receiver = Receiver;
+	}
+}
+
+void ULocomotionSubsystem::UnregisterNotifyReceiver(const USkeletalMeshComponent* Mesh)
+{
+	NotifyQueues.Remove(Mesh);
+}
+
+void ULocomotionSubsystem::QueueNotify(const USkeletalMeshComponent* Mesh, ELocomotionNotifyEvent Event)
+{
+	FNotifyQueue* Queue = NotifyQueues.Find(Mesh);
+	if (!Queue)
+	{
+		return;
+	}
+
+	if (Queue->PendingEvents == 0)
+	{
+		PendingNotifyMeshes.Add(Mesh);
+	}
+	Queue->PendingEvents |= 1u << static_cast<uint32>(Event);
+}
+
+void ULocomotionSubsystem::DrainNotifies()
+{
+	// Receivers may queue further events while handling these, those wait for the next drain
+	Swap(DrainingNotifyMeshes, PendingNotifyMeshes);
+
+	for (const USkeletalMeshComponent* Mesh : DrainingNotifyMeshes)
+	{
+		FNotifyQueue* Queue = NotifyQueues.Find(Mesh);
+		if (!Queue)
+		{
+			continue;
+		}
+
+		ILocomotionNotifyReceiver* Receiver = Queue->Receiver;
+		uint32 Events = Queue->PendingEvents;
+		Queue->PendingEvents = 0;
+
+		while (Events != 0)
+		{
+			const uint32 Index = FMath::CountTrailingZeros(Events);
+			Events &= Events - 1;
+			Receiver->HandleLocomotionNotify(static_cast<ELocomotionNotifyEvent>(Index));
+		}
+	}
+	DrainingNotifyMeshes.Reset();
+}
+
+void ULocomotionSubsystem::OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime)
+{
+	// Notifies fire while the meshes tick, after this frame's movement. Handling them here instead of in the next
+	// pass gets them in the same frame, before the next movement tick consumes a launch
+	if (World == GetWorld())
+	{
+		DrainNotifies();
+	}
+}
+
+bool ULocomotionSubsystem::IsDormancyEnabled()
+{
+	return CVarLocomotionDormancy.GetValueOnGameThread();
+}
+
+float ULocomotionSubsystem::GetDormancyIdleGrace()
+{
+	return CVarLocomotionDormancyIdleGrace.GetValueOnGameThread();
+}
+
+void ULocomotionSubsystem::SetCharacterDormant(APlayerCharacter* Character, bool bDormant)
+{
+	if (!IsValid(Character) || Character->bLocomotionDormant == bDormant)
+	{
+		return;
+	}
+
+	// Waking appends to Characters, which the pass tolerates mid-loop, going dormant only happens between passes
+	TArray<TObjectPtr<APlayerCharacter>>& From = bDormant ? Characters : DormantCharacters;
+	TArray<TObjectPtr<APlayerCharacter>>& To = bDormant ? DormantCharacters : Characters;
+	if (From.RemoveSingleSwap(Character) == 0)
+	{
+		return;
+	}
+	To.Add(Character);
+
+	// Time spent dormant is not simulated on wake, and the idle grace starts over
+	Character->bLocomotionDormant = bDormant;
+	Character->LocomotionTickAccumulator = 0.f;
+	Character->IdleSeconds = 0.f;
+	Character->SetActorTickEnabled(!bDormant && !bBatchTicking);
+}
+
+void ULocomotionSubsystem::OnCharacterControllerChanged(APlayerCharacter* Character)
+{
+	if (Characters.Contains(Character) || DormantCharacters.Contains(Character))
+	{
+		SetControllerPrerequisite(Character, bBatchTicking);
+	}
+}
+
+void ULocomotionSubsystem::SetControllerPrerequisite(APlayerCharacter* Character, bool bBatched)
+{
+	// Controller input and rotation land before the character's actor tick, the pass has to see them the same way.
+	// A controller possesses one pawn at a time, so each link belongs to exactly one character
+	if (AController* Previous = Character->BatchTickController.Get())
+	{
+		BatchTickFunction.RemovePrerequisite(Previous, Previous->PrimaryActorTick);
+		Character->BatchTickController = nullptr;
+	}
+
+	AController* Controller = Character->GetController();
+	if (bBatched && Controller)
+	{
+		BatchTickFunction.AddPrerequisite(Controller, Controller->PrimaryActorTick);
+		Character->BatchTickController = Controller;
+	}
+}
+
+void ULocomotionSubsystem::SetCharacterBatched(APlayerCharacter* Character, bool bBatched)
+{
+	if (!IsValid(Character))
+	{
+		return;
+	}
+
+	SetControllerPrerequisite(Character, bBatched);
+
+	// Movement must consume the batched input in the same frame, like it does after the actor tick,
+	// and animation must read the snapshot published by this frame's pass
+	FTickFunction& MovementTick = Character->GetCharacterMovement()->PrimaryComponentTick;
+	FTickFunction& MeshTick = Character->GetMesh()->PrimaryComponentTick;
+	if (bBatched)
+	{
+		MovementTick.AddPrerequisite(this, BatchTickFunction);
+		MeshTick.AddPrerequisite(this, BatchTickFunction);
+	}
+	else
+	{
+		MovementTick.RemovePrerequisite(this, BatchTickFunction);
+		MeshTick.RemovePrerequisite(this, BatchTickFunction);
+	}
+
+	Character->SetActorTickEnabled(!bBatched && !Character->bLocomotionDormant);
+}
+
+void ULocomotionSubsystem::TickCharacters(float DeltaTime)
+{
+#if LOCOMOTION_DEBUG
+	// Draw everything the characters queued since the last pass in one go
+	if (FLocomotionDebugBuffer* DebugBuffer = FLocomotionDebugBuffer::Get(GetWorld()))
+	{
+		DebugBuffer->Flush(GetWorld());
+	}
+#endif
+
+	if (Comparison)
+	{
+		UpdateTickComparison();
+	}
+	else if (CVarLocomotionBatchTick.GetValueOnGameThread() != bBatchTicking)
+	{
+		SetBatchTicking(!bBatchTicking);
+	}
+
+	UpdateSignificance();
+
+	// Anything queued after the last end of frame drain still lands before the rules run, like input
+	DrainNotifies();
+
+	if (!IsDormancyEnabled() && DormantCharacters.Num() > 0)
+	{
+		const TArray<TObjectPtr<APlayerCharacter>> ToWake = DormantCharacters;
+		for (APlayerCharacter* Character : ToWake)
+		{
+			SetCharacterDormant(Character, false);
+		}
+	}
+
+	if (!bBatchTicking || Characters.Num() == 0)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_LocomotionBatchTick);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const int32 Num = Characters.Num();
+	PassCharacters.Reset();
+	PassCharacters.Append(Characters);
+	States.SetNum(Num, EAllowShrinking::No);
+	Inputs.SetNum(Num, EAllowShrinking::No);
+	Outputs.SetNum(Num, EAllowShrinking::No);
+	Settings.SetNum(Num, EAllowShrinking::No);
+
+	// Gather world data on the game thread
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LocomotionBatchGather);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			APlayerCharacter* Character = PassCharacters[Index];
+			if (!IsValid(Character))
+			{
+				Settings[Index] = nullptr;
+				continue;
+			}
+
+			// Characters on a reduced tick rate skip frames and simulate the accumulated time when due
+			const float CharacterDeltaTime = Character->ConsumeLocomotionTickTime(DeltaTime * Character->CustomTimeDilation);
+			if (CharacterDeltaTime <= 0.f)
+			{
+				Settings[Index] = nullptr;
+				continue;
+			}
+
+			Inputs[Index] = FLocomotionTickInput();
+			Character->GatherLocomotionInput(CharacterDeltaTime, Inputs[Index]);
+			States[Index] = Character->LocomotionState;
+			Settings[Index] = Character->LocomotionSettings;
+		}
+	}
+
+	// Run the rules over contiguous state
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LocomotionBatchRules);
+		const EParallelForFlags Flags = Num < CVarLocomotionParallelThreshold.GetValueOnGameThread() ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None;
+		ParallelFor(Num, [this](int32 Index)
+		{
+			if (const FLocomotionSettings* CharacterSettings = Settings[Index])
+			{
+				Locomotion::Tick(States[Index], *CharacterSettings, Inputs[Index], Outputs[Index]);
+			}
+		}, Flags);
+	}
+
+	// Apply movement input and stance changes back on the game thread
+	{
+		SCOPE_CYCLE_COUNTER(STAT_LocomotionBatchApply);
+		for (int32 Index = 0; Index < Num; ++Index)
+		{
+			APlayerCharacter* Character = PassCharacters[Index];
+			if (!Settings[Index] || !IsValid(Character))
+			{
+				continue;
+			}
+
+			Character->LocomotionState = States[Index];
+			Character->ApplyLocomotionOutput(Outputs[Index]);
+
+			// The disabled actor tick would drop the Blueprint Tick event
+			if (Character->bHasBlueprintTick)
+			{
+				Character->ReceiveTick(Inputs[Index].DeltaTime);
+			}
+
+			if (Character->UpdateIdleTime(Locomotion::IsIdle(Character->LocomotionState, Inputs[Index]), Inputs[Index].DeltaTime))
+			{
+				PendingDormant.Add(Character);
+			}
+		}
+	}
+
+	for (APlayerCharacter* Character : PendingDormant)
+	{
+		SetCharacterDormant(Character, true);
+	}
+	PendingDormant.Reset();
+	PassCharacters.Reset();
+
+	LastBatchTickMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+}
+
+void ULocomotionSubsystem::StartTickComparison(const TArray<int32>& CharacterCounts, int32 FramesPerMode)
+{
+	if (Comparison || CharacterCounts.Num() == 0)
+	{
+		return;
+	}
+
+	Comparison = MakeUnique<FTickComparison>();
+	Comparison->CharacterCounts = CharacterCounts;
+	Comparison->FramesPerMode = FramesPerMode;
+	Comparison->bWasBatchTicking = bBatchTicking;
+	Comparison->bWasDormancyEnabled = CVarLocomotionDormancy.GetValueOnGameThread();
+	Comparison->bWasTickLODEnabled = CVarLocomotionTickLOD.GetValueOnGameThread();
+	CVarLocomotionDormancy->Set(false, ECVF_SetByConsole);
+	CVarLocomotionTickLOD->Set(false, ECVF_SetByConsole);
+
+	UE_LOG(LogLocomotion, Log, TEXT("Tick comparison: %d frames per mode, movement components, dormancy and tick LOD disabled to isolate locomotion tick cost"), FramesPerMode);
+
+	SpawnComparisonCharacters(CharacterCounts[0]);
+	SetBatchTicking(false);
+}
+
+void ULocomotionSubsystem::UpdateTickComparison()
+{
+	constexpr int32 WarmupFrames = 30;
+
+	FTickComparison& Run = *Comparison;
+	++Run.Frame;
+
+	// GGameThreadTime holds the previous frame, the warmup frames absorb the mode switch
+	if (Run.Frame > WarmupFrames)
+	{
+		const double GameThreadMs = FPlatformTime::ToMilliseconds(GGameThreadTime);
+		(Run.bBatchPhase ? Run.BatchMsSum : Run.PerActorMsSum) += GameThreadMs;
+	}
+
+	if (Run.Frame < WarmupFrames + Run.FramesPerMode)
+	{
+		return;
+	}
+
+	if (!Run.bBatchPhase)
+	{
+		Run.bBatchPhase = true;
+		Run.Frame = 0;
+		SetBatchTicking(true);
+		return;
+	}
+
+	const double PerActorMs = Run.PerActorMsSum / Run.FramesPerMode;
+	const double BatchMs = Run.BatchMsSum / Run.FramesPerMode;
+	UE_LOG(LogLocomotion, Log, TEXT("Tick comparison %6d characters: per-actor %.3f ms, batched %.3f ms, speedup %.2fx"),
+		Run.CharacterCounts[Run.CountIndex], PerActorMs, BatchMs, BatchMs > 0.0 ? PerActorMs / BatchMs : 0.0);
+
+	DestroyComparisonCharacters();
+
+	++Run.CountIndex;
+	if (Run.CountIndex >= Run.CharacterCounts.Num())
+	{
+		EndTickComparison();
+		return;
+	}
+
+	Run.Frame = 0;
+	Run.bBatchPhase = false;
+	Run.PerActorMsSum = 0.0;
+	Run.BatchMsSum = 0.0;
+	SpawnComparisonCharacters(Run.CharacterCounts[Run.CountIndex]);
+	SetBatchTicking(false);
+}
+
+void ULocomotionSubsystem::EndTickComparison()
+{
+	if (!Comparison)
+	{
+		return;
+	}
+
+	CVarLocomotionDormancy->Set(Comparison->bWasDormancyEnabled, ECVF_SetByConsole);
+	CVarLocomotionTickLOD->Set(Comparison->bWasTickLODEnabled, ECVF_SetByConsole);
+	SetBatchTicking(Comparison->bWasBatchTicking);
+	Comparison.Reset();
+}
+
+void ULocomotionSubsystem::SpawnComparisonCharacters(int32 Count)
+{
+	UWorld* World = GetWorld();
+
+	const TSubclassOf<APlayerCharacter> CharacterClass = LocomotionUtils::GetDefaultCharacterClass(World);
+
+	FActorSpawnParameters Params;
+	Params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	const int32 Columns = FMath::CeilToInt(FMath::Sqrt(static_cast<float>(Count)));
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		const FVector Location(200.f * (Index % Columns), 200.f * (Index / Columns), 200.f);
+		if (APlayerCharacter* Character = World->SpawnActor<APlayerCharacter>(CharacterClass, Location, FRotator::ZeroRotator, Params))
+		{
+			Character->GetCharacterMovement()->SetComponentTickEnabled(false);
+			Comparison->Spawned.Add(Character);
+		}
+	}
+}
+
+void ULocomotionSubsystem::DestroyComparisonCharacters()
+{
+	for (const TWeakObjectPtr<APlayerCharacter>& Character : Comparison->Spawned)
+	{
+		if (Character.IsValid())
+		{
+			Character->Destroy();
+		}
+	}
+	Comparison->Spawned.Reset();
+}
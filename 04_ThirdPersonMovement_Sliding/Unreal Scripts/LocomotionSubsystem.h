@@ -0,0 +1,160 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LocomotionCore.h"
+#include "LocomotionNotifyReceiver.h"
+#include "LocomotionSubsystem.generated.h"
+
+class APlayerCharacter;
+class ULocomotionSubsystem;
+class USkeletalMeshComponent;
+
+DECLARE_LOG_CATEGORY_EXTERN(LogLocomotion, Log, All);
+
+/**
+ * Tick function that runs the batched locomotion pass in TG_PrePhysics,
+ * before the character movement components consume the gathered input.
+ */
+USTRUCT()
+struct FLocomotionBatchTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	ULocomotionSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FLocomotionBatchTickFunction> : public TStructOpsTypeTraitsBase2<FLocomotionBatchTickFunction>
+{
+	enum { WithCopy = false };
+};
+
+/**
+ * Ticks every registered APlayerCharacter in one pass instead of one actor tick each.
+ * Game thread gathers world data (movement mode, slide ground probe), the locomotion rules
+ * run in a ParallelFor over contiguous state, then movement input and stance changes are applied
+ * back on the game thread. Toggle with Locomotion.BatchTick.
+ * Characters are registered with the significance manager, far or off-screen ones tick at 10-20 Hz (Locomotion.TickLOD).
+ * The game calls USignificanceManager::Update, or sets Locomotion.TickLOD.UpdateSignificance to have this subsystem call it.
+ * Idle characters go dormant and cost nothing per frame until an event wakes them.
+ * The pass runs after the controllers of the batched characters. Their actor tick is off while batched, the pass
+ * calls a Blueprint Tick event in its place. Dormant characters get no Tick event in either mode.
+ */
+UCLASS()
+class MECHANICS_TEST_LVN_API ULocomotionSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+	void RegisterCharacter(APlayerCharacter* Character);
+	void UnregisterCharacter(APlayerCharacter* Character);
+
+	// Possession changed, the pass waits for the new controller's tick like the character's own tick would
+	void OnCharacterControllerChanged(APlayerCharacter* Character);
+
+	// Switches every registered character between the batched pass and its own actor tick
+	void SetBatchTicking(bool bEnabled);
+	bool IsBatchTicking() const { return bBatchTicking; }
+
+	// Idle characters leave the pass until an input, anim notify or movement mode change wakes them (Locomotion.Dormancy)
+	void SetCharacterDormant(APlayerCharacter* Character, bool bDormant);
+	static bool IsDormancyEnabled();
+	// Seconds a character stays idle before it goes dormant (Locomotion.Dormancy.IdleGrace)
+	static float GetDormancyIdleGrace();
+
+	// Anim notify events from UAnimNotify_Locomotion, handed to the mesh's receiver once the frame's actors and components
+	// have ticked, so a jump launch or flip is applied before the next movement tick
+	void RegisterNotifyReceiver(const USkeletalMeshComponent* Mesh, ILocomotionNotifyReceiver* Receiver);
+	void UnregisterNotifyReceiver(const USkeletalMeshComponent* Mesh);
+	void QueueNotify(const USkeletalMeshComponent* Mesh, ELocomotionNotifyEvent Event);
+
+	int32 GetNumCharacters() const { return Characters.Num() + DormantCharacters.Num(); }
+	int32 GetNumDormantCharacters() const { return DormantCharacters.Num(); }
+	double GetLastBatchTickMs() const { return LastBatchTickMs; }
+
+	void TickCharacters(float DeltaTime);
+
+	// Significance for the tick LOD: 1 ticks every frame, 0.5 at the visible rate, 0 at the hidden rate
+	static float CalculateSignificance(const APlayerCharacter* Character, const FTransform& Viewpoint);
+	static float GetTickIntervalForSignificance(float Significance);
+
+	// Spawns each count of characters and logs game thread time with per-actor ticking vs the batched pass
+	void StartTickComparison(const TArray<int32>& CharacterCounts, int32 FramesPerMode);
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void SetCharacterBatched(APlayerCharacter* Character, bool bBatched);
+	void SetControllerPrerequisite(APlayerCharacter* Character, bool bBatched);
+	void UpdateSignificance();
+	void DrainNotifies();
+	void OnWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaTime);
+	void UpdateTickComparison();
+	void SpawnComparisonCharacters(int32 Count);
+	void DestroyComparisonCharacters();
+	void EndTickComparison();
+
+	FLocomotionBatchTickFunction BatchTickFunction;
+
+	// Awake characters, ticked every pass
+	UPROPERTY()
+	TArray<TObjectPtr<APlayerCharacter>> Characters;
+
+	UPROPERTY()
+	TArray<TObjectPtr<APlayerCharacter>> DormantCharacters;
+
+	// Characters that went idle during the pass, moved to DormantCharacters once the pass is done
+	TArray<APlayerCharacter*> PendingDormant;
+
+	// Contiguous working set for the parallel pass, reused every frame. PassCharacters is the snapshot of Characters the
+	// pass indexes by, unregistering mid-pass clears the slot instead of reordering it
+	TArray<APlayerCharacter*> PassCharacters;
+	TArray<FLocomotionState> States;
+	TArray<FLocomotionTickInput> Inputs;
+	TArray<FLocomotionTickOutput> Outputs;
+	TArray<const FLocomotionSettings*> Settings;
+	TArray<FTransform> Viewpoints;
+
+	// Pending notify events per mesh as a mask, so each receiver gets them once and in enum order
+	struct FNotifyQueue
+	{
+		ILocomotionNotifyReceiver* Receiver = nullptr;
+		uint32 PendingEvents = 0;
+	};
+
+	TMap<const USkeletalMeshComponent*, FNotifyQueue> NotifyQueues;
+	TArray<const USkeletalMeshComponent*> PendingNotifyMeshes;
+	TArray<const USkeletalMeshComponent*> DrainingNotifyMeshes;
+	FDelegateHandle PostActorTickHandle;
+
+	bool bBatchTicking = true;
+	double LastBatchTickMs = 0.0;
+
+	// Tick mode comparison run
+	struct FTickComparison
+	{
+		TArray<int32> CharacterCounts;
+		int32 CountIndex = 0;
+		int32 FramesPerMode = 0;
+		int32 Frame = 0;
+		bool bBatchPhase = false;
+		double PerActorMsSum = 0.0;
+		double BatchMsSum = 0.0;
+		bool bWasBatchTicking = true;
+		// Dormancy and tick LOD are off for the run and restored after it, idle spawned characters would otherwise stop ticking
+		bool bWasDormancyEnabled = true;
+		bool bWasTickLODEnabled = true;
+		TArray<TWeakObjectPtr<APlayerCharacter>> Spawned;
+	};
+
+	TUniquePtr<FTickComparison> Comparison;
+};
@@ -0,0 +1,52 @@
+#include "LocomotionTuning.h"
+
+void ULocomotionTuning::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	BuildSettings();
+}
+
+void ULocomotionTuning::PostLoad()
+{
+	Super::PostLoad();
+
+	BuildSettings();
+}
+
+#if WITH_EDITOR
+void ULocomotionTuning::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	BuildSettings();
+}
+#endif
+
+void ULocomotionTuning::BuildSettings()
+{
+	Settings.WalkSpeed = WalkSpeed;
+	Settings.SprintSpeed = SprintSpeed;
+	Settings.JumpBufferTime = JumpBufferTime;
+	Settings.bAllowDoubleJump = bAllowDoubleJump;
+	Settings.CrouchSpeed = CrouchSpeed;
+	Settings.CrouchCapsuleHalfHeight = CrouchCapsuleHalfHeight;
+	Settings.StandCapsuleHalfHeight = StandCapsuleHalfHeight;
+	Settings.CustomCapsuleCrouchOffset = CustomCapsuleCrouchOffset;
+	Settings.MaxSlideSpeed = MaxSlideSpeed;
+	Settings.SlideAirThreshold = SlideAirThreshold;
+	Settings.SlideSpeed = SlideSpeed;
+	Settings.MinSlideSpeed = MinSlideSpeed;
+	Settings.SlideFriction = SlideFriction;
+	Settings.SlideFallGraceTime = SlideFallGraceTime;
+	Settings.RampBoostSpeed = RampBoostSpeed;
+	Settings.FlatSlideBoost = FlatSlideBoost;
+	Settings.UphillPenaltyReferenceRate = UphillPenaltyReferenceRate;
+	Settings.SlideFixedStepRate = SlideFixedStepRate;
+	Settings.MaxSlideSubsteps = MaxSlideSubsteps;
+	Settings.MaxSlideStepTime = MaxSlideStepTime;
+	Settings.bSlideInMovementMode = bUseSlideMovementMode;
+	Settings.ProneCapsuleHalfHeight = ProneCapsuleHalfHeight;
+	Settings.ProneSpeed = ProneSpeed;
+	Settings.CustomCapsuleProneOffset = CustomCapsuleProneOffset;
+}
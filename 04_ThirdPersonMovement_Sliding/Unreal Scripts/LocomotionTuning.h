@@ -0,0 +1,180 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "LocomotionCore.h"
+#include "LocomotionTuning.generated.h"
+
+/**
+ * Movement, jump, crouch, slide, prone, camera and replication tuning, shared by every APlayerCharacter that
+ * references the asset. Characters keep only a pointer, so a crowd reads one FLocomotionSettings instead of a
+ * copy per actor. Treat the asset as read-only at runtime, a change applies to every character using it.
+ * Characters without an asset use the class defaults below.
+ */
+UCLASS(BlueprintType)
+class MECHANICS_TEST_LVN_API ULocomotionTuning : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// Core settings built from the properties below
+	const FLocomotionSettings& GetSettings() const { return Settings; }
+
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	// Camera
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Camera")
+	float SensitivityMultiplier = 0.75f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Camera")
+	float VerticalSensitivityMultiplier = 0.75f;
+
+	// Boom pitch at spawn, look pitch is clamped to 15 degrees below and 45 above it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Camera")
+	float CameraSpawnPitch = -20.f;
+
+	// Movement
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
+	float RotationSpeed = 10.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
+	float WalkSpeed = 300.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
+	float SprintSpeed = 600.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
+	float WalkableSlopeAngle = 40.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Movement")
+	float StepOffset = 30.f;
+
+	// Jumping
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Jumping")
+	float JumpForce = 1000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Jumping")
+	float FlipJumpForce = 800.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Jumping")
+	float CustomAirControl = 1.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Jumping")
+	float CustomGravityScale = 2.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Jumping")
+	float JumpBufferTime = 0.1f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Jumping")
+	bool bAllowDoubleJump = true;
+
+	// Crouch
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crouch")
+	float CrouchSpeed = 200.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crouch")
+	float CrouchCapsuleHalfHeight = 44.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crouch")
+	float StandCapsuleHalfHeight = 88.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Crouch")
+	float CustomCapsuleCrouchOffset = -40.f;
+
+	// Sliding
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float MaxSlideSpeed = 3000.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float SlideAirThreshold = 500.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float SlideSpeed = 600.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float MinSlideSpeed = 200.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float SlideFriction = 2.25f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float SlideFallGraceTime = 0.5f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float RampBoostSpeed = 1500.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	float FlatSlideBoost = 300.f;
+
+	// Tick rate in Hz the uphill penalty is tuned at, the slide loses the same speed per second at any other rate. 0 applies it once per step
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding", meta = (ClampMin = "0"))
+	float UphillPenaltyReferenceRate = 60.f;
+
+	// Fixed slide integration rate in Hz so slides match between server and client frame rates, 0 steps once per tick
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding", meta = (ClampMin = "0"))
+	float SlideFixedStepRate = 0.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding", meta = (ClampMin = "1"))
+	int32 MaxSlideSubsteps = 8;
+
+	// Without a fixed rate, longer ticks (tick LOD, hitches) integrate the slide in steps no longer than this
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding", meta = (ClampMin = "0"))
+	float MaxSlideStepTime = 0.05f;
+
+	// Slide in the movement component's own mode instead of steering the walking physics, needs ULocomotionMovementComponent
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Sliding")
+	bool bUseSlideMovementMode = true;
+
+	// Prone
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prone")
+	float ProneCapsuleHalfHeight = 40.f;
+
+	// How far a ceiling may sit below the standing capsule top and still allow standing up. Crouching needs the full crouch height
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prone")
+	float CeilingCheckOffset = 5.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prone")
+	float ClearanceCacheTolerance = 2.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prone")
+	float ProneSpeed = 125.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Prone")
+	float CustomCapsuleProneOffset = -20.f;
+
+	// Replication rate from the locomotion state, set on the server. Sliding, jumping, flipping and falling use the action rate,
+	// prone, dancing and standing still the idle rate, everything else the moving rate
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication")
+	bool bAdaptiveNetUpdate = true;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "1"))
+	float IdleNetUpdateFrequency = 5.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "1"))
+	float MovingNetUpdateFrequency = 30.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "1"))
+	float ActionNetUpdateFrequency = 100.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "0"))
+	float IdleNetPriority = 1.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "0"))
+	float MovingNetPriority = 2.f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "0"))
+	float ActionNetPriority = 3.f;
+
+	// Below this speed a standing or crouched character counts as idle
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Replication", meta = (ClampMin = "0"))
+	float IdleNetSpeedThreshold = 10.f;
+
+private:
+	void BuildSettings();
+
+	FLocomotionSettings Settings;
+};
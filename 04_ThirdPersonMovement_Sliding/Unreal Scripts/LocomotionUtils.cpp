@@ -0,0 +1,25 @@
+#include "LocomotionUtils.h"
+#include "PlayerCharacter.h"
+#include "Engine/World.h"
+#include "GameFramework/GameModeBase.h"
+#include "Misc/Paths.h"
+
+namespace LocomotionUtils
+{
+	TSubclassOf<APlayerCharacter> GetDefaultCharacterClass(const UWorld* World)
+	{
+		if (const AGameModeBase* GameMode = World ? World->GetAuthGameMode() : nullptr)
+		{
+			if (GameMode->DefaultPawnClass && GameMode->DefaultPawnClass->IsChildOf(APlayerCharacter::StaticClass()))
+			{
+				return GameMode->DefaultPawnClass.Get();
+			}
+		}
+		return APlayerCharacter::StaticClass();
+	}
+
+	FString ResolvePath(const FString& Path, const FString& RelativeTo)
+	{
+		return FPaths::IsRelative(Path) ? RelativeTo / Path : Path;
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+
+class APlayerCharacter;
+class UWorld;
+
+// Helpers shared by the locomotion subsystems and test tools
+namespace LocomotionUtils
+{
+	// The game mode's default pawn when it is an APlayerCharacter, APlayerCharacter otherwise
+	TSubclassOf<APlayerCharacter> GetDefaultCharacterClass(const UWorld* World);
+
+	// Path as given when absolute, otherwise under RelativeTo
+	FString ResolvePath(const FString& Path, const FString& RelativeTo);
+}
@@ -8,41 +8,29 @@
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/PlayerController.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "LocomotionCoreBridge.h"
+#include "LocomotionDebug.h"
+#include "LocomotionSubsystem.h"
+#include "Misc/App.h"
+#include "Net/UnrealNetwork.h"
 
-    APlayerCharacter::APlayerCharacter()
+    const FName APlayerCharacter::CameraBoomName(TEXT("CameraBoom"));
+    const FName APlayerCharacter::FollowCameraName(TEXT("FollowCamera"));
+
+    APlayerCharacter::APlayerCharacter(const FObjectInitializer& ObjectInitializer)
+        : Super(ObjectInitializer.SetDefaultSubobjectClass<ULocomotionMovementComponent>(ACharacter::CharacterMovementComponentName))
     {
         PrimaryActorTick.bCanEverTick = true;
 
-        // Camera boom settings
-        CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
-        CameraBoom->SetupAttachment(RootComponent);
-        CameraBoom->TargetArmLength = 375.f;
-        CameraBoom->bUsePawnControlRotation = true;
-        CameraBoom->bEnableCameraLag = true;
-        CameraBoom->CameraLagSpeed = 10.f;
-        CameraBoom->bEnableCameraRotationLag = true;
-        CameraBoom->CameraRotationLagSpeed = 10.f;
-        CameraBoom->bDoCollisionTest = true;
-
-        // Follow camera
-        FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
-        FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
-        FollowCamera->FieldOfView = 110.f;
-        FollowCamera->bUsePawnControlRotation = false;
-
-        // Configurable spawn pitch
-        CameraSpawnPitch = -20.f;
-        InitialCameraSpawnPitch = CameraSpawnPitch;
-
-        // Movement
-        bIsRunning = false;
-        RotationSpeed = 10.f;
-        WalkSpeed = 300.f;
-        SprintSpeed = 600.f;
-
-        // Sensitivity
-        SensitivityMultiplier = 0.75f;
-        VerticalSensitivityMultiplier = 0.75f;
+        // Camera rig, optional so ALightweightPlayerCharacter can leave it to EnsureCameraRig
+        CameraBoom = CreateOptionalDefaultSubobject<USpringArmComponent>(CameraBoomName);
+        FollowCamera = CreateOptionalDefaultSubobject<UCameraComponent>(FollowCameraName);
+        if (CameraBoom && FollowCamera)
+        {
+            CameraBoom->SetupAttachment(RootComponent);
+            FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
+            ConfigureCameraRig();
+        }
 
         // Character rotation settings
         bUseControllerRotationYaw = false;
@@ -52,27 +40,51 @@
         GetCharacterMovement()->bOrientRotationToMovement = false;
         GetCharacterMovement()->bUseControllerDesiredRotation = false;
 
-        // Slopes
-        WalkableSlopeAngle = 40.f;
-        StepOffset = 30.f;
-        GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
-        GetCharacterMovement()->AirControl = CustomAirControl;
-        GetCharacterMovement()->GravityScale = CustomGravityScale;
+        // Tuning defaults until BeginPlay picks up the assigned asset
+        RefreshLocomotionSettings();
+    }
+
+    void APlayerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+    {
+        Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+        // The owning client gets the server's flags with its move corrections instead
+        DOREPLIFETIME_CONDITION(APlayerCharacter, ReplicatedLocomotionFlags, COND_SimulatedOnly);
     }
 
     void APlayerCharacter::BeginPlay()
     {
         Super::BeginPlay();
 
-        GetCharacterMovement()->SetWalkableFloorAngle(WalkableSlopeAngle);
-        GetCharacterMovement()->MaxStepHeight = StepOffset;
         GetCharacterMovement()->PerchRadiusThreshold = 10.f;
         GetCharacterMovement()->bEnablePhysicsInteraction = true;
         GetCharacterMovement()->bEnableScopedMovementUpdates = true;
         GetCharacterMovement()->BrakingDecelerationWalking = 1800.f;
         GetCharacterMovement()->GroundFriction = 8.f;
 
-        CameraBoom->SetRelativeRotation(FRotator(CameraSpawnPitch, 0.f, 0.f));
+        RefreshLocomotionSettings();
+        LocomotionState = FLocomotionState();
+        PublishAnimSnapshot();
+
+        if (CameraBoom)
+            CameraBoom->SetRelativeRotation(FRotator(GetTuning()->CameraSpawnPitch, 0.f, 0.f));
+
+        bHasBlueprintTick = GetClass()->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(APlayerCharacter, ReceiveTick))
+            && (bAllowReceiveTickEventOnDedicatedServer || !IsRunningDedicatedServer());
+
+        // Hand the locomotion tick over to the batched world pass when it is available
+        if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+        {
+            LocomotionSubsystem->RegisterCharacter(this);
+        }
+    }
+
+    void APlayerCharacter::PawnClientRestart()
+    {
+        // Only a local player needs the camera and input, the rig must exist before the input component binds
+        EnsureCameraRig();
+
+        Super::PawnClientRestart();
 
         if (APlayerController* PC = Cast<APlayerController>(GetController()))
         {
@@ -84,193 +96,326 @@
         }
     }
 
-    void APlayerCharacter::Tick(float DeltaTime)
+    void APlayerCharacter::EnsureCameraRig()
     {
-        Super::Tick(DeltaTime);
+        if (CameraBoom && FollowCamera)
+            return;
 
-        const bool bIsGrounded = GetCharacterMovement()->IsMovingOnGround();
-        const bool bIsFalling = GetCharacterMovement()->IsFalling();
+        CameraBoom = NewObject<USpringArmComponent>(this, CameraBoomName);
+        CameraBoom->SetupAttachment(RootComponent);
+        FollowCamera = NewObject<UCameraComponent>(this, FollowCameraName);
+        FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName);
+        ConfigureCameraRig();
 
-        // Handle airborne crouch/prone transitions
-        if (bIsCrouching && bIsFalling)
-        {
-            bIsProning = false;
-            return;
-        }
-        else if (bIsProning && bIsFalling)
-        {
-            bIsProning = false;
-            bIsInProneTransition = false;
-            bIsCrouching = true;
-            return;
-        }
-        else if (bIsCrouching || bIsProning)
+        CameraBoom->SetRelativeRotation(FRotator(GetTuning()->CameraSpawnPitch, 0.f, 0.f));
+        CameraBoom->RegisterComponent();
+        FollowCamera->RegisterComponent();
+        AddInstanceComponent(CameraBoom);
+        AddInstanceComponent(FollowCamera);
+    }
+
+    void APlayerCharacter::ConfigureCameraRig()
+    {
+        CameraBoom->TargetArmLength = 375.f;
+        CameraBoom->bUsePawnControlRotation = true;
+        CameraBoom->bEnableCameraLag = true;
+        CameraBoom->CameraLagSpeed = 10.f;
+        CameraBoom->bEnableCameraRotationLag = true;
+        CameraBoom->CameraRotationLagSpeed = 10.f;
+        CameraBoom->bDoCollisionTest = true;
+
+        FollowCamera->FieldOfView = 110.f;
+        FollowCamera->bUsePawnControlRotation = false;
+    }
+
+    void APlayerCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+    {
+        StopInputRecording();
+        StopInputReplay();
+
+        if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
         {
-            return;
+            LocomotionSubsystem->UnregisterCharacter(this);
         }
 
-        // Sliding logic
-        if (bIsSliding)
-        {
-            FVector GroundNormal = FVector::UpVector;
-            FHitResult Hit;
-            FVector Start = GetActorLocation();
-            FVector End = Start - FVector(0.f, 0.f, 150.f);
+        Super::EndPlay(EndPlayReason);
+    }
 
-            bool bIsDownhillAligned = false;
-            float SlideExitSpeedThreshold = MinSlideSpeed;
-            float Alignment = 0.f;
+    void APlayerCharacter::Tick(float DeltaTime)
+    {
+        Super::Tick(DeltaTime);
 
-            if (GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility))
-            {
-                GroundNormal = Hit.Normal;
+        FLocomotionTickInput Input;
+        GatherLocomotionInput(DeltaTime, Input);
 
-                float Incline = FVector::DotProduct(GroundNormal, FVector::UpVector);
-                float SlopeAngle = FMath::RadiansToDegrees(FMath::Acos(Incline));
+        FLocomotionTickOutput Output;
+        Locomotion::Tick(LocomotionState, GetLocomotionSettings(), Input, Output);
 
-                FVector DownhillDir = FVector::CrossProduct(GroundNormal, FVector::CrossProduct(FVector::UpVector, GroundNormal)).GetSafeNormal();
-                Alignment = FVector::DotProduct(SlideVelocity.GetSafeNormal(), DownhillDir);
+        ApplyLocomotionOutput(Output);
 
-                // Uncomment for slope and align debugging
-                //DrawDebugString(GetWorld(), Start, FString::Printf(TEXT("Slope: %.1f° Align: %.2f"), SlopeAngle, Alignment), nullptr, FColor::White, 0.1f);
+        if (UpdateIdleTime(Locomotion::IsIdle(LocomotionState, Input), Input.DeltaTime))
+        {
+            if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+            {
+                LocomotionSubsystem->SetCharacterDormant(this, true);
+            }
+        }
+    }
 
-                // Downhill boost
-                if (SlopeAngle > 10.f && Alignment < 0.5f)
-                {
-                    float BoostScale = FMath::Clamp((1.f - Alignment) * (SlopeAngle / 30.f), 0.5f, 2.5f);
-                    SlideVelocity += DownhillDir * RampBoostSpeed * DeltaTime * BoostScale;
+    void APlayerCharacter::OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode)
+    {
+        Super::OnMovementModeChanged(PrevMovementMode, PreviousCustomMode);
 
-                    //UE_LOG(LogTemp, Log, TEXT("Ramp boost applied: Slope %.1f°, Align %.2f"), SlopeAngle, Alignment);
-                    bIsDownhillAligned = true;
-                }
+        WakeLocomotion();
+        UpdateNetUpdateRate();
+    }
 
-                // Uphill penalty
-                if (Alignment > 0.f)
-                {
-                    float UphillPenalty = FMath::Clamp(Alignment, 0.2f, 1.f);
-                    SlideVelocity *= 1.f - UphillPenalty * 0.5f;
+    void APlayerCharacter::NotifyControllerChanged()
+    {
+        Super::NotifyControllerChanged();
 
-                    //UE_LOG(LogTemp, Log, TEXT("Uphill penalty applied: Align %.2f, Scale %.2f"), Alignment, 1.f - UphillPenalty * 0.5f);
-                }
+        if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+        {
+            LocomotionSubsystem->OnCharacterControllerChanged(this);
+        }
+    }
 
-                // Adjust exit threshold for downhill
-                SlideExitSpeedThreshold = bIsDownhillAligned ? MinSlideSpeed * 0.5f : MinSlideSpeed;
+    bool APlayerCharacter::CanGoDormant() const
+    {
+        // Recordings need a frame marker every frame
+        return ULocomotionSubsystem::IsDormancyEnabled() && !InputRecorder && !InputReplay;
+    }
 
-                // Flat boost scaled and interpolated
-                float FlatBoostScale = FMath::Clamp(1.f - Alignment, 0.f, 1.f);
-                FVector TargetFlatBoost = GetActorForwardVector() * FlatSlideBoost * FlatBoostScale;
-                SlideVelocity = FMath::VInterpTo(SlideVelocity, TargetFlatBoost, DeltaTime, 3.0f);
-            }
+    bool APlayerCharacter::UpdateIdleTime(bool bIdle, float DeltaTime)
+    {
+        IdleSeconds = bIdle ? IdleSeconds + DeltaTime : 0.f;
+        return bIdle && CanGoDormant() && IdleSeconds >= ULocomotionSubsystem::GetDormancyIdleGrace();
+    }
 
-            // Clamp max slide speed
-            SlideVelocity = SlideVelocity.GetClampedToMaxSize(MaxSlideSpeed);
-            GetCharacterMovement()->MaxWalkSpeed = MaxSlideSpeed;
+    void APlayerCharacter::WakeLocomotion()
+    {
+        if (!bLocomotionDormant)
+            return;
 
-            // Apply movement
-            AddMovementInput(SlideVelocity.GetSafeNormal(), SlideVelocity.Size() * DeltaTime);
+        if (ULocomotionSubsystem* LocomotionSubsystem = GetWorld()->GetSubsystem<ULocomotionSubsystem>())
+        {
+            LocomotionSubsystem->SetCharacterDormant(this, false);
+        }
+    }
 
-            // Track airborne slide time
-            if (!bIsGrounded)
-            {
-                SlideFallTimer += DeltaTime;
-            }
-            else
-            {
-                SlideFallTimer = 0.f;
-            }
+    void APlayerCharacter::GatherLocomotionInput(float DeltaTime, FLocomotionTickInput& Input)
+    {
+        // Recorded events go in before the rules run, same as live input, and the recorded delta time replaces the live one
+        if (InputReplay)
+        {
+            ReplayInputFrame(DeltaTime);
+        }
 
-            // Grace period timer
-            if (SlideStartTimer > 0.f)
-            {
-                SlideStartTimer -= DeltaTime;
-            }
+        FLocomotionFrameContext& Frame = GetFrameContext();
 
-            // Exit slide conditions
-            bool bShouldExitSlide = SlideVelocity.Size() < SlideExitSpeedThreshold && !bIsDownhillAligned;
+        Input.DeltaTime = DeltaTime;
+        Input.Time = GetWorld()->GetTimeSeconds();
+        Input.bIsGrounded = Frame.bIsGrounded;
+        Input.bIsFalling = Frame.bIsFalling;
+        Input.ActorForward = LocomotionBridge::ToLocomotion(GetActorForwardVector());
+        Input.Velocity = LocomotionBridge::ToLocomotion(GetVelocity());
+        Input.Acceleration = LocomotionBridge::ToLocomotion(GetCharacterMovement()->GetCurrentAcceleration());
 
-            if (SlideStartTimer <= 0.f && (bShouldExitSlide || SlideFallTimer > SlideFallGraceTime || !bIsRunning))
+        FLocomotionGroundInfoStats::AddCharacterFrame();
+
+        // Ground probe for slope boost / uphill penalty, only needed while sliding
+        if (Locomotion::NeedsSlideGroundProbe(LocomotionState, GetLocomotionSettings()))
+        {
+            const FLocomotionGroundInfo& Ground = Frame.GetGround();
+            if (Ground.bHit && Ground.Distance <= SlideGroundProbeDistance)
             {
-                ExitSlide();
-                return;
+                Input.bHasSlideGroundHit = true;
+                Input.SlideGroundNormal = LocomotionBridge::ToLocomotion(Ground.Normal);
             }
+        }
 
-            
-            SlideVelocity = FMath::VInterpTo(SlideVelocity, FVector::ZeroVector, DeltaTime, SlideFriction);
+        // The movement component floor covers grounded frames, keep a trace in flight only while airborne
+        const bool bNeedsAirborneProbe = LocomotionState.IsSliding() || LocomotionState.bIsRunning;
+        if (FLocomotionGroundProbe::IsAsyncEnabled() && !Input.bIsGrounded && bNeedsAirborneProbe)
+        {
+            FCollisionQueryParams Params;
+            Params.AddIgnoredActor(this);
+
+            const FVector Predicted = GetActorLocation() + GetVelocity() * DeltaTime;
+            GroundProbe.Issue(GetWorld(), Predicted, Predicted - FVector(0.f, 0.f, GroundProbeDistance), Params);
+        }
+        else
+        {
+            GroundProbe.Reset();
         }
 
-        // Jump buffer
-        if (bJumpInputQueued)
+        if (InputRecorder)
         {
-            JumpBufferTimer -= DeltaTime;
-            if (JumpBufferTimer <= 0.f)
-            {
-                bJumpInputQueued = false;
-            }
+            InputRecorder->EndFrame(DeltaTime);
         }
 
-        // Grounded jump reset
-        if (bIsGrounded)
+        if (RollbackBuffer)
         {
-            JumpCount = 0;
-            bJumpPending = false;
-            bIsFlipping = false;
+            BeginRollbackFrame();
+            RollbackFrameInput.Tick = Input;
         }
+    }
 
-        // Buffered jump
-        if (bIsGrounded && bJumpInputQueued && !bJumpPending)
+    FLocomotionEventResult APlayerCharacter::HandleLocomotionEvent(ELocomotionEvent Event, const FVector2D& Value)
+    {
+        FLocomotionFrameContext& Frame = GetFrameContext();
+        BeginRollbackFrame();
+
+        FLocomotionEventContext Context;
+        Context.Time = GetWorld()->GetTimeSeconds();
+        Context.bIsGrounded = Frame.bIsGrounded;
+        Context.bIsFalling = Frame.bIsFalling;
+        Context.bHasController = Controller != nullptr;
+        Context.ActorForward = LocomotionBridge::ToLocomotion(GetActorForwardVector());
+        Context.CapsuleHalfHeight = GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+        Context.MoveInput.X = Value.X;
+        Context.MoveInput.Y = Value.Y;
+
+        // Traces and sweeps only for the events that read them
+        Context.Queries = Locomotion::GetEventQueries(LocomotionState, Event);
+        if (Context.Queries & FLocomotionEventContext::QueryGround)
         {
-            bJumpPending = true;
-            bJumpInputQueued = false;
-            JumpCount++;
-            bIsJumping = true;
+            Context.GroundSpeed = GetCharacterMovement()->Velocity.Size();
+            Context.GroundDistance = GetGroundDistance();
+        }
+        if (Context.Queries & FLocomotionEventContext::QueryClearance)
+        {
+            const FLocomotionClearance& Clearance = Frame.GetClearance();
+            Context.bCanStand = Clearance.CanStand();
+            Context.bCanCrouch = Clearance.CanCrouch();
         }
 
-        // Double jump
-        if (!bIsGrounded && bAllowDoubleJump && JumpCount < 2 && bJumpInputQueued && !bJumpPending)
+        const FLocomotionEventResult Result = Locomotion::HandleEvent(LocomotionState, GetLocomotionSettings(), Event, Context);
+        ApplyStanceChange(Result.StanceChange);
+        if (Result.bSetMaxWalkSpeed)
         {
-            bIsFlipping = true;
-            bIsJumping = true;
-            bJumpPending = true;
-            bJumpInputQueued = false;
-            JumpCount++;
+            GetCharacterMovement()->MaxWalkSpeed = Result.MaxWalkSpeed;
         }
 
-        // Reset jump flag when falling
-        if (bIsJumping && bIsFalling)
+        if (RollbackBuffer)
         {
-            bIsJumping = false;
+            LocomotionRollback::RecordEvent(RollbackFrameInput, Event, Context);
         }
+        return Result;
     }
 
+    void APlayerCharacter::BeginRollbackFrame()
+    {
+        if (!RollbackBuffer || bRollbackFrameStarted)
+            return;
+
+        RollbackFrameStart = CaptureLocomotionSnapshot();
+        RollbackFrameInput = FLocomotionFrameInput();
+        RollbackFrameInput.bRunHeld = LocomotionState.bIsRunning;
+        bRollbackFrameStarted = true;
+    }
 
-    void APlayerCharacter::Move(const FInputActionValue& Value)
+    void APlayerCharacter::EndRollbackFrame()
     {
-        FVector2D Input = Value.Get<FVector2D>();
-        MovementInput = Input;
+        if (!RollbackBuffer || !bRollbackFrameStarted)
+            return;
+
+        RollbackBuffer->Record(RollbackFrame++, RollbackFrameStart, RollbackFrameInput);
+        bRollbackFrameStarted = false;
+    }
 
-        if (!Controller || bIsInProneTransition)
+    void APlayerCharacter::ApplyLocomotionOutput(const FLocomotionTickOutput& Output)
+    {
+        if (Output.bSetMaxWalkSpeed)
+        {
+            GetCharacterMovement()->MaxWalkSpeed = Output.MaxWalkSpeed;
+        }
+
+        if (Output.bApplySlideMovement)
+        {
+            AddMovementInput(LocomotionBridge::ToFVector(Output.SlideMoveDirection), Output.SlideMoveScale);
+        }
+
+        DrawSlideDebug(Output);
+
+        if (Output.bExitSlide)
+        {
+            ExitSlide();
+        }
+
+        PublishAnimSnapshot();
+        EndRollbackFrame();
+    }
+
+    void APlayerCharacter::UpdateNetUpdateRate()
+    {
+        const ULocomotionTuning* Tune = GetTuning();
+        if (!Tune->bAdaptiveNetUpdate || !HasAuthority() || GetNetMode() == NM_Standalone)
             return;
 
-        if (bIsDancing)
+        const UCharacterMovementComponent* MoveComp = GetCharacterMovement();
+
+        ENetUpdateTier Tier = ENetUpdateTier::Moving;
+        if (LocomotionState.IsSliding() || LocomotionState.IsJumping() || LocomotionState.IsFlipping() || MoveComp->IsFalling())
+            Tier = ENetUpdateTier::Action;
+        else if (LocomotionState.IsProning() || LocomotionState.IsDancing() || MoveComp->Velocity.SizeSquared() < FMath::Square(Tune->IdleNetSpeedThreshold))
+            Tier = ENetUpdateTier::Idle;
+
+        // Runs after every movement tick, but the stance, jump phase, mode and speed band rarely change between them
+        if (Tier == NetUpdateTier)
+            return;
+        NetUpdateTier = Tier;
+
+        const float Frequency = Tier == ENetUpdateTier::Action ? Tune->ActionNetUpdateFrequency : Tier == ENetUpdateTier::Idle ? Tune->IdleNetUpdateFrequency : Tune->MovingNetUpdateFrequency;
+        const float Priority = Tier == ENetUpdateTier::Action ? Tune->ActionNetPriority : Tier == ENetUpdateTier::Idle ? Tune->IdleNetPriority : Tune->MovingNetPriority;
+
+        const bool bRaised = Frequency > NetUpdateFrequency;
+        NetUpdateFrequency = Frequency;
+        NetPriority = Priority;
+
+        // Slide starts and flips go out now instead of waiting out the idle interval
+        if (bRaised)
+        {
+            ForceNetUpdate();
+        }
+    }
+
+    void APlayerCharacter::DrawSlideDebug(const FLocomotionTickOutput& Output) const
+    {
+        if (Output.bHasSlideSlope)
         {
-            if (!Input.IsNearlyZero())
+            LOCOMOTION_DEBUG_STRING(GetWorld(), Slide, GetActorLocation(), FString::Printf(TEXT("Slope: %.1f° Align: %.2f"), Output.SlideSlopeAngle, Output.SlideAlignment), FColor::White, 0.1f);
+            if (Output.bRampBoostApplied)
             {
-                bIsDancing = false;
+                LOCOMOTION_DEBUG_LOG(Slide, TEXT("Ramp boost applied: Slope %.1f°, Align %.2f"), Output.SlideSlopeAngle, Output.SlideAlignment);
             }
-            else
+            if (Output.bUphillPenaltyApplied)
             {
-                return;
+                LOCOMOTION_DEBUG_LOG(Slide, TEXT("Uphill penalty applied: Align %.2f"), Output.SlideAlignment);
             }
         }
+    }
 
-        FRotator CameraRot = FollowCamera->GetComponentRotation();
-        CameraRot.Pitch = 0.f;
-        CameraRot.Roll = 0.f;
+    void APlayerCharacter::PublishAnimSnapshot()
+    {
+        PackedAnimSnapshot.store(FLocomotionAnimSnapshot::FromState(LocomotionState).Pack(), std::memory_order_release);
+    }
+
+
+    void APlayerCharacter::Move(const FInputActionValue& Value)
+    {
+        FVector2D Input = Value.Get<FVector2D>();
+
+        if (!RouteInput(ELocomotionInputEvent::Move, Input))
+            return;
+
+        // Stores the input, ends a dance and applies the walk speed for its direction
+        if (!HandleLocomotionEvent(ELocomotionEvent::Move, Input).bAcceptedMove)
+            return;
 
-        const FVector Forward = FRotationMatrix(CameraRot).GetUnitAxis(EAxis::X);
-        const FVector Right = FRotationMatrix(CameraRot).GetUnitAxis(EAxis::Y);
+        FLocomotionFrameContext& Frame = GetFrameContext();
 
-        FVector MoveInput = Forward * Input.Y + Right * Input.X;
+        FVector MoveInput = Frame.GetCameraForward() * Input.Y + Frame.GetCameraRight() * Input.X;
 
         if (MoveInput.IsNearlyZero())
             return;
@@ -286,220 +431,404 @@
 
         FRotator Current = GetActorRotation();
         FRotator TargetYawOnly(0.f, DesiredRot.Yaw, 0.f);
-        FRotator NewRot = FMath::RInterpTo(Current, TargetYawOnly, GetWorld()->GetDeltaSeconds(), RotationSpeed);
+        FRotator NewRot = FMath::RInterpTo(Current, TargetYawOnly, Frame.DeltaTime, GetTuning()->RotationSpeed);
         SetActorRotation(NewRot);
-
-        if (bIsSliding)
-        {
-            return;
-        }
-        if (bIsProning)
-        {
-            GetCharacterMovement()->MaxWalkSpeed = ProneSpeed;
-        }
-        else if (bIsCrouching)
-        {
-            GetCharacterMovement()->MaxWalkSpeed = CrouchSpeed;
-        }
-        else if (bIsRunning && Input.Y >= 0.f)
-        {
-            GetCharacterMovement()->MaxWalkSpeed = SprintSpeed;
-        }
-        else
-        {
-            GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
-        }
     }
 
     void APlayerCharacter::Look(const FInputActionValue& Value)
     {
         const FVector2D LookInput = Value.Get<FVector2D>();
+        if (!RouteInput(ELocomotionInputEvent::Look, LookInput))
+            return;
+
         if (!LookInput.IsNearlyZero())
         {
-            AddControllerYawInput(LookInput.X * SensitivityMultiplier);
-            AddControllerPitchInput(LookInput.Y * VerticalSensitivityMultiplier);
+            const ULocomotionTuning* Tune = GetTuning();
+            AddControllerYawInput(LookInput.X * Tune->SensitivityMultiplier);
+            AddControllerPitchInput(LookInput.Y * Tune->VerticalSensitivityMultiplier);
 
             FRotator ControlRot = GetControlRotation();
             ControlRot.Pitch = FMath::ClampAngle(
                 ControlRot.Pitch,
-                InitialCameraSpawnPitch - 15.f,
-                InitialCameraSpawnPitch + 45.f
+                Tune->CameraSpawnPitch - 15.f,
+                Tune->CameraSpawnPitch + 45.f
             );
             GetController()->SetControlRotation(ControlRot);
         }
     }
 
-    void APlayerCharacter::TryStartSlide()
+    void APlayerCharacter::ExitSlide()
     {
-        // Check if already sliding or in a conflicting state
-        if (bIsSliding || bIsCrouching || bIsProning || !IsRunning() || MovementInput.Size() < 0.1f || GetForwardInput() < 0.f || GetCharacterMovement()->Velocity.Size() <= 0.f)
-            return;
+        const FLocomotionClearance& Clearance = GetFrameContext().GetClearance();
+        if (bRollbackFrameStarted)
+        {
+            RollbackFrameInput.bCanStand = Clearance.CanStand();
+            RollbackFrameInput.bCanCrouch = Clearance.CanCrouch();
+        }
 
-        // Check if character is grounded OR close enough to the ground to allow mid-air slide
-        float GroundDistance = GetGroundDistance();
+        ApplyStanceChange(Locomotion::ExitSlide(LocomotionState, GetLocomotionSettings(), Clearance.CanStand(), Clearance.CanCrouch()));
 
-        if (!GetCharacterMovement()->IsMovingOnGround() && GroundDistance > SlideAirThreshold)
+        if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
+        {
+            Movement->StopSlideMode();
+        }
+    }
+
+    void APlayerCharacter::ApplyStanceChange(const FLocomotionStanceChange& Change)
+    {
+        if (!Change.bApply)
             return;
 
-        // Begin slide
-        bIsSliding = true;
-        SlideStartTimer = 0.2f;
-        SlideVelocity = GetActorForwardVector() * SlideSpeed;
+        UCapsuleComponent* Capsule = GetCapsuleComponent();
+        const float OffsetZ = SolveStanceOffsetZ(Change);
+        bool bSwept = false;
+        {
+            // Offset, capsule and mesh commit together, overlaps update once when the scope ends
+            FScopedMovementUpdate ScopedUpdate(Capsule, EScopedUpdate::DeferredUpdates);
+
+            // The mesh picks up its new offset with the capsule move instead of moving twice
+            GetMesh()->SetRelativeLocation_Direct(FVector(0.f, 0.f, Change.MeshOffsetZ));
+
+            if (OffsetZ != 0.f)
+            {
+                // Without a floor below, a downward offset still needs its one sweep
+                bSwept = OffsetZ < 0.f && !GetCharacterMovement()->CurrentFloor.bBlockingHit;
+                AddActorWorldOffset(FVector(0.f, 0.f, OffsetZ), bSwept);
+            }
+            else
+            {
+                GetMesh()->UpdateComponentToWorld();
+            }
 
-        float NewHeight = ProneCapsuleHalfHeight;
-        GetCapsuleComponent()->SetCapsuleHalfHeight(NewHeight, true);
-        GetMesh()->SetRelativeLocation(FVector(0.f, 0.f, -NewHeight));
+            Capsule->SetCapsuleHalfHeight(Change.CapsuleHalfHeight, false);
+            ScopedUpdate.ForceOverlapUpdate();
+        }
+
+        FLocomotionGroundInfoStats::AddStanceChange(bSwept);
+        FrameContext.InvalidateSpatialQueries();
+        LOCOMOTION_DEBUG_LOG(Stance, TEXT("%s capsule half height %.1f, offset %.1f%s"), *GetName(), Change.CapsuleHalfHeight, OffsetZ, bSwept ? TEXT(" (swept)") : TEXT(""));
+
+        if (Change.bSetMaxWalkSpeed)
+        {
+            GetCharacterMovement()->MaxWalkSpeed = Change.MaxWalkSpeed;
+        }
     }
 
-    void APlayerCharacter::ExitSlide()
+    float APlayerCharacter::SolveStanceOffsetZ(const FLocomotionStanceChange& Change) const
     {
-        bIsSliding = false;
+        if (Change.PreOffsetZ == 0.f && Change.OffsetZ == 0.f)
+            return 0.f;
 
-        const bool bCanStand = CanStandUp();
-        const bool bCanCrouch = CanCrouchUpFromProne();
+        const UCapsuleComponent* Capsule = GetCapsuleComponent();
 
-        UCapsuleComponent* Capsule = GetCapsuleComponent();
-        USkeletalMeshComponent* PlayerMesh = GetMesh();
+        // Below: the floor the movement component already found, above: the cached clearance sweep
+        float FloorGap = -1.f;
+        const FFindFloorResult& Floor = GetCharacterMovement()->CurrentFloor;
+        if (Floor.bBlockingHit)
+            FloorGap = FMath::Max(Floor.GetDistanceToFloor() - UCharacterMovementComponent::MIN_FLOOR_DIST, 0.f);
+
+        float CeilingGap = -1.f;
+        if (Change.PreOffsetZ > 0.f || Change.OffsetZ > 0.f)
+            CeilingGap = FMath::Max(QueryClearance().Headroom - Capsule->GetUnscaledCapsuleHalfHeight(), 0.f);
+
+        return Locomotion::ResolveStanceOffsetZ(Change, FloorGap, CeilingGap);
+    }
 
-        if (bCanStand && bCanCrouch)
+    void APlayerCharacter::ApplyMoveLocomotionFlags(ELocomotionStance Stance, bool bRunning, bool bQueueJump)
+    {
+        const ELocomotionStance PreviousStance = LocomotionState.Stance;
+        const bool bWasRunning = LocomotionState.bIsRunning;
+
+        float NewMaxWalkSpeed = 0.f;
+        if (bRunning != bWasRunning && Locomotion::SetRunning(LocomotionState, GetLocomotionSettings(), bRunning, NewMaxWalkSpeed))
         {
-            Capsule->SetCapsuleHalfHeight(StandCapsuleHalfHeight, true);
-            PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -StandCapsuleHalfHeight));
-            bIsCrouching = false;
-            bIsProning = false;
-            GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
+            GetCharacterMovement()->MaxWalkSpeed = NewMaxWalkSpeed;
         }
-        else if (bCanCrouch)
+
+        if (bQueueJump)
         {
-            Capsule->SetCapsuleHalfHeight(CrouchCapsuleHalfHeight, true);
-            PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -CrouchCapsuleHalfHeight));
-            bIsCrouching = true;
-            bIsProning = false;
-            GetCharacterMovement()->MaxWalkSpeed = CrouchSpeed;
+            Locomotion::QueueJumpInput(LocomotionState, GetLocomotionSettings(), GetWorld()->GetTimeSeconds());
+        }
+
+        // A rejected stance stays on the server's, the correction's move response carries it back to the client
+        if (LocomotionStance::GetInfo(Stance).Parent != LocomotionStance::GetInfo(PreviousStance).Parent)
+        {
+            const FLocomotionClearance& Clearance = GetFrameContext().GetClearance();
+            ApplyStanceChange(Locomotion::ForceStance(LocomotionState, GetLocomotionSettings(), Stance, LocomotionBridge::ToLocomotion(GetActorForwardVector()),
+                Clearance.CanStand(), Clearance.CanCrouch()));
+        }
+
+        if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
+        {
+            if (LocomotionState.IsSliding())
+                Movement->StartSlideMode();
+            else
+                Movement->StopSlideMode();
+        }
+
+        if (LocomotionState.Stance != PreviousStance || bRunning != bWasRunning || bQueueJump)
+        {
+            WakeLocomotion();
+            if (LocomotionState.IsSliding() || bQueueJump)
+                WakeLocomotionTick();
+            UpdateNetUpdateRate();
+        }
+    }
+
+    void APlayerCharacter::ApplyServerLocomotionFlags(ELocomotionStance Stance, bool bRunning)
+    {
+        const ELocomotionStance PreviousStance = LocomotionState.Stance;
+        const bool bWasRunning = LocomotionState.bIsRunning;
+
+        float NewMaxWalkSpeed = 0.f;
+        if (bRunning != bWasRunning && Locomotion::SetRunning(LocomotionState, GetLocomotionSettings(), bRunning, NewMaxWalkSpeed))
+        {
+            GetCharacterMovement()->MaxWalkSpeed = NewMaxWalkSpeed;
+        }
+
+        // The server already validated the stance, clearance and transitions do not apply here
+        ApplyStanceChange(Locomotion::AdoptStance(LocomotionState, GetLocomotionSettings(), Stance, LocomotionBridge::ToLocomotion(GetActorForwardVector())));
+
+        if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
+        {
+            if (LocomotionState.IsSliding())
+                Movement->StartSlideMode();
+            else
+                Movement->StopSlideMode();
+        }
+
+        if (LocomotionState.Stance != PreviousStance || bRunning != bWasRunning)
+        {
+            WakeLocomotion();
+            if (LocomotionState.IsSliding())
+                WakeLocomotionTick();
+            PublishAnimSnapshot();
+        }
+    }
+
+    void APlayerCharacter::OnRep_ReplicatedLocomotionFlags()
+    {
+        ApplyServerLocomotionFlags(FSavedMove_Locomotion::UnpackStance(ReplicatedLocomotionFlags), (ReplicatedLocomotionFlags & FSavedMove_Locomotion::FLAG_Running) != 0);
+    }
+
+    void APlayerCharacter::RefreshLocomotionSettings()
+    {
+        const ULocomotionTuning* Tune = GetTuning();
+
+        // Shared as they are, only a character without the slide movement mode keeps its own copy
+        if (Tune->bUseSlideMovementMode && !GetLocomotionMovement())
+        {
+            LocomotionSettingsOverride = MakeUnique<FLocomotionSettings>(Tune->GetSettings());
+            LocomotionSettingsOverride->bSlideInMovementMode = false;
+            LocomotionSettings = LocomotionSettingsOverride.Get();
         }
         else
         {
-            Capsule->SetCapsuleHalfHeight(ProneCapsuleHalfHeight, true);
-            PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -ProneCapsuleHalfHeight));
-            bIsCrouching = true;
-            bIsProning = true;
-            GetCharacterMovement()->MaxWalkSpeed = ProneSpeed;
+            LocomotionSettingsOverride.Reset();
+            LocomotionSettings = &Tune->GetSettings();
         }
+
+        UCharacterMovementComponent* MoveComp = GetCharacterMovement();
+        MoveComp->MaxWalkSpeed = Tune->WalkSpeed;
+        MoveComp->AirControl = Tune->CustomAirControl;
+        MoveComp->GravityScale = Tune->CustomGravityScale;
+        MoveComp->SetWalkableFloorAngle(Tune->WalkableSlopeAngle);
+        MoveComp->MaxStepHeight = Tune->StepOffset;
     }
 
-    float APlayerCharacter::GetGroundDistance() const
+    void APlayerCharacter::SetTuning(ULocomotionTuning* NewTuning)
     {
-        FVector Start = GetActorLocation();
-        FVector End = Start - FVector(0.f, 0.f, 200.f); // Trace 200 units downward
+        Tuning = NewTuning;
+        RefreshLocomotionSettings();
+        bHasCachedClearance = false;
+        NetUpdateTier = ENetUpdateTier::None;
+
+        // Capsule and speed of the current stance from the new values
+        FLocomotionStanceChange Change = Locomotion::MakeStanceChange(GetLocomotionSettings(), LocomotionState.Stance);
+        Change.bSetMaxWalkSpeed = Locomotion::ResolveMaxWalkSpeed(LocomotionState, GetLocomotionSettings(), LocomotionState.MovementInput.Y, Change.MaxWalkSpeed);
+        ApplyStanceChange(Change);
+        WakeLocomotion();
+    }
 
+    FLocomotionGroundInfo APlayerCharacter::QueryGroundInfo(float MaxDistance) const
+    {
+        FLocomotionGroundInfo Info;
+
+        // The movement component already swept for the floor this frame while walking
+        const UCharacterMovementComponent* MoveComp = GetCharacterMovement();
+        const FFindFloorResult& Floor = MoveComp->CurrentFloor;
+        if (MoveComp->IsMovingOnGround() && Floor.bBlockingHit)
+        {
+            FLocomotionGroundInfoStats::AddFloorReuse();
+
+            Info.bFromMovementFloor = true;
+            Info.bWalkable = Floor.bWalkableFloor;
+            Info.Normal = Floor.HitResult.ImpactNormal;
+            Info.Distance = GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + Floor.GetDistanceToFloor();
+            Info.bHit = Info.Distance <= MaxDistance;
+            return Info;
+        }
+
+        // Airborne, the floor was cleared when the character left the ground
+        FVector Start = GetActorLocation();
         FHitResult Hit;
-        FCollisionQueryParams Params;
-        Params.AddIgnoredActor(this);
+        bool bHit = false;
+
+        // Prefer the probe issued last frame, fall back to a synchronous trace
+        if (GroundProbe.TryGetResult(GetWorld(), Hit, bHit))
+        {
+            Start = GroundProbe.GetStart();
+        }
+        else
+        {
+            FLocomotionGroundInfoStats::AddTrace();
+
+            FCollisionQueryParams Params;
+            Params.AddIgnoredActor(this);
+
+            bHit = GetWorld()->LineTraceSingleByChannel(Hit, Start, Start - FVector(0.f, 0.f, GroundProbeDistance), ECC_Visibility, Params);
+        }
 
-        bool bHit = GetWorld()->LineTraceSingleByChannel(Hit, Start, End, ECC_Visibility, Params);
-        DrawDebugLine(GetWorld(), Start, End, bHit ? FColor::Green : FColor::Red, false, 1.0f, 0, 2.0f);
-        
         if (bHit)
         {
-            return (Start - Hit.Location).Size();
+            Info.bWalkable = MoveComp->IsWalkable(Hit);
+            Info.Normal = Hit.Normal;
+            Info.Distance = (Start - Hit.Location).Size();
+            Info.bHit = Info.Distance <= MaxDistance;
         }
+        return Info;
+    }
 
-        return MAX_FLT; 
+    FLocomotionFrameContext& APlayerCharacter::GetFrameContext() const
+    {
+        if (!FrameContext.IsCurrent(GFrameCounter))
+        {
+            FrameContext.Begin(*this, GFrameCounter);
+        }
+        return FrameContext;
+    }
+
+    float APlayerCharacter::GetGroundDistance() const
+    {
+        const FLocomotionGroundInfo& Ground = GetFrameContext().GetGround();
+
+        LOCOMOTION_DEBUG_LINE(GetWorld(), Ground, GetActorLocation(), GetActorLocation() - FVector(0.f, 0.f, GroundProbeDistance), Ground.bHit ? FColor::Green : FColor::Red, 1.0f, 2.0f);
+
+        return Ground.bHit ? Ground.Distance : MAX_FLT;
     }
 
 
 
     void APlayerCharacter::RunPressed()
     {
-        bIsRunning = true;
+        if (!RouteInput(ELocomotionInputEvent::RunPressed))
+            return;
 
-        if (MovementInput.Y >= 0.f)
-        {
-            if (GetCharacterMovement()->MaxWalkSpeed != SprintSpeed)
-            {
-                GetCharacterMovement()->MaxWalkSpeed = SprintSpeed;
-            }
-        }
+        HandleLocomotionEvent(ELocomotionEvent::RunPressed);
     }
 
     void APlayerCharacter::RunReleased()
     {
-        bIsRunning = false;
+        if (!RouteInput(ELocomotionInputEvent::RunReleased))
+            return;
 
-        if (GetCharacterMovement()->MaxWalkSpeed != WalkSpeed)
-        {
-            GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
-        }
+        HandleLocomotionEvent(ELocomotionEvent::RunReleased);
     }
 
     void APlayerCharacter::Dance()
     {
-        bIsDancing = true;
+        if (!RouteInput(ELocomotionInputEvent::Dance))
+            return;
+
+        HandleLocomotionEvent(ELocomotionEvent::Dance);
     }
 
     void APlayerCharacter::QueueJumpInput()
     {
-        if (bIsDancing || bIsCrouching || bIsProning){return;}
-        bJumpInputQueued = true;
-        JumpBufferTimer = JumpBufferTime;
+        if (!RouteInput(ELocomotionInputEvent::Jump))
+            return;
+
+        HandleLocomotionEvent(ELocomotionEvent::Jump);
+        WakeLocomotionTick();
+    }
+
+    void APlayerCharacter::SetLocomotionTickInterval(float Interval)
+    {
+        if (Interval == LocomotionTickInterval)
+            return;
+
+        LocomotionTickInterval = Interval;
+
+        // The actor tick only runs the rules when the batched pass is off, the movement component always follows the LOD
+        SetActorTickInterval(Interval);
+        GetCharacterMovement()->SetComponentTickInterval(Interval);
+    }
+
+    float APlayerCharacter::ConsumeLocomotionTickTime(float DeltaTime)
+    {
+        LocomotionTickAccumulator += DeltaTime;
+        if (LocomotionTickAccumulator < LocomotionTickInterval)
+            return 0.f;
+
+        const float TickTime = LocomotionTickAccumulator;
+        LocomotionTickAccumulator = 0.f;
+        return TickTime;
+    }
+
+    void APlayerCharacter::WakeLocomotionTick()
+    {
+        SetLocomotionTickInterval(0.f);
+    }
+
+    void APlayerCharacter::HandleLocomotionNotify(ELocomotionNotifyEvent Event)
+    {
+        switch (Event)
+        {
+        case ELocomotionNotifyEvent::ApplyJumpForce: ApplyJumpForce(); break;
+        case ELocomotionNotifyEvent::TriggerFlip: TriggerFlip(); break;
+        case ELocomotionNotifyEvent::EndFlip: EndFlip(); break;
+        case ELocomotionNotifyEvent::StartProneTransition: StartProneTransition(); break;
+        case ELocomotionNotifyEvent::EndProneTransition: EndProneTransition(); break;
+        default: break;
+        }
     }
 
     void APlayerCharacter::ApplyJumpForce()
     {
-        LaunchCharacter(FVector(0.f, 0.f, JumpForce), false, true);
-        bJumpPending = false;
+        WakeLocomotion();
+        LaunchCharacter(FVector(0.f, 0.f, GetTuning()->JumpForce), false, true);
+        HandleLocomotionEvent(ELocomotionEvent::ApplyJumpForce);
     }
 
     void APlayerCharacter::TriggerFlip()
     {
-        bIsFlipping = true;
-        bIsJumping = true;
-        bJumpPending = true;
-        JumpCount++;
-        LaunchCharacter(FVector(0.f, 0.f, FlipJumpForce), false, true);
+        WakeLocomotion();
+        HandleLocomotionEvent(ELocomotionEvent::TriggerFlip);
+        LaunchCharacter(FVector(0.f, 0.f, GetTuning()->FlipJumpForce), false, true);
+        UpdateNetUpdateRate();
     }
 
     void APlayerCharacter::EndFlip()
     {
-        bIsFlipping = false;
-        bIsJumping = false;
+        WakeLocomotion();
+        HandleLocomotionEvent(ELocomotionEvent::EndFlip);
     }
 
     void APlayerCharacter::HandleCrouchOrSlidePressed()
     {
-        if (bIsProning || IsJumping() || IsFlipping() || bIsInProneTransition)
+        if (!RouteInput(ELocomotionInputEvent::CrouchPressed))
             return;
 
-        float GroundDistance = GetGroundDistance();
-        const bool bNearGround = GroundDistance <= SlideAirThreshold;
-        const bool bCanSlide = !bIsSliding && IsRunning() && MovementInput.Size() > 0.1f;
-
-        if (bCanSlide && (GetCharacterMovement()->IsMovingOnGround() || bNearGround))
-        {
-            TryStartSlide(); // Start slide (held behavior)
-        }
-        else if (GetCharacterMovement()->IsMovingOnGround())
+        // Starts a slide (held behavior) or toggles crouch
+        const FLocomotionEventResult Result = HandleLocomotionEvent(ELocomotionEvent::CrouchPressed);
+        if (Result.StanceChange.bApply && LocomotionState.IsSliding())
         {
-            // Toggle crouch
-            UCapsuleComponent* Capsule = GetCapsuleComponent();
-            USkeletalMeshComponent* PlayerMesh = GetMesh();
+            WakeLocomotionTick();
+            UpdateNetUpdateRate();
 
-            if (bIsCrouching)
-            {
-                if (CanStandUp())
-                {
-                    Capsule->SetCapsuleHalfHeight(StandCapsuleHalfHeight, true);
-                    PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -StandCapsuleHalfHeight));
-                    bIsCrouching = false;
-                    GetCharacterMovement()->MaxWalkSpeed = WalkSpeed;
-                }
-            }
-            else
+            if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
             {
-                Capsule->SetCapsuleHalfHeight(CrouchCapsuleHalfHeight, true);
-                PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -CrouchCapsuleHalfHeight));
-                bIsCrouching = true;
-                GetCharacterMovement()->MaxWalkSpeed = CrouchSpeed;
+                Movement->StartSlideMode();
             }
         }
     }
@@ -508,9 +837,15 @@
 
     void APlayerCharacter::HandleCrouchReleased()
     {
-        if (bIsSliding)
+        if (!RouteInput(ELocomotionInputEvent::CrouchReleased))
+            return;
+
+        if (HandleLocomotionEvent(ELocomotionEvent::CrouchReleased).StanceChange.bApply)
         {
-            ExitSlide();
+            if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
+            {
+                Movement->StopSlideMode();
+            }
         }
     }
 
@@ -519,93 +854,297 @@
 
     void APlayerCharacter::ToggleProne()
     {
-        if (bIsInProneTransition || IsRunning() || IsJumping() || IsFlipping() || GetCharacterMovement()->IsFalling())
-        {
+        if (!RouteInput(ELocomotionInputEvent::Prone))
             return;
+
+        HandleLocomotionEvent(ELocomotionEvent::Prone);
+    }
+
+
+
+    const FLocomotionClearance& APlayerCharacter::QueryClearance() const
+    {
+        const ULocomotionTuning* Tune = GetTuning();
+        const FVector Location = GetActorLocation();
+        const float HalfHeight = GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight();
+        if (bHasCachedClearance && HalfHeight == CachedClearanceHalfHeight
+            && FVector::DistSquared(Location, CachedClearanceLocation) <= FMath::Square(Tune->ClearanceCacheTolerance))
+        {
+            return CachedClearance;
         }
 
-        UCapsuleComponent* Capsule = GetCapsuleComponent();
-        UMeshComponent* PlayerMesh = GetMesh();
+        // One sweep from the top of the current capsule up to the standing height covers both stance checks
+        const float Radius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+        const FLocomotionClearanceSweep Sweep = Locomotion::MakeClearanceSweep(GetLocomotionSettings(), HalfHeight, Radius);
+        const FVector Start = Location + FVector(0.f, 0.f, Sweep.StartHeight);
+        const FVector End = Location + FVector(0.f, 0.f, Sweep.EndHeight);
+
+        FLocomotionGroundInfoStats::AddClearanceSweep();
+
+        FCollisionQueryParams Params;
+        Params.AddIgnoredActor(this);
+
+        FHitResult Hit;
+        const bool bHit = GetWorld()->SweepSingleByChannel(Hit, Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Radius), Params);
+
+        CachedClearance = Locomotion::ResolveClearance(GetLocomotionSettings(), Sweep, Tune->CeilingCheckOffset, bHit, bHit && Hit.bStartPenetrating, Hit.Distance);
+        CachedClearanceLocation = Location;
+        CachedClearanceHalfHeight = HalfHeight;
+        bHasCachedClearance = true;
+        return CachedClearance;
+    }
+
+    bool APlayerCharacter::CanStandUp() const
+    {
+        return QueryClearance().CanStand();
+    }
 
-        if (bIsProning)
+    bool APlayerCharacter::CanCrouchUpFromProne() const
+    {
+        return QueryClearance().CanCrouch();
+    }
+
+    void APlayerCharacter::StartProneTransition()
+    {
+        WakeLocomotion();
+        HandleLocomotionEvent(ELocomotionEvent::StartProneTransition);
+    }
+
+    void APlayerCharacter::EndProneTransition()
+    {
+        WakeLocomotion();
+        HandleLocomotionEvent(ELocomotionEvent::EndProneTransition);
+    }
+
+    bool APlayerCharacter::RouteInput(ELocomotionInputEvent Event, const FVector2D& Value)
+    {
+        // Live input is ignored while a recording drives the character
+        if (InputReplay && !bDispatchingReplayInput)
+            return false;
+
+        if (InputRecorder)
+        {
+            InputRecorder->Record(Event, Value);
+        }
+
+        // Look input does not change locomotion state
+        if (Event != ELocomotionInputEvent::Look)
+        {
+            WakeLocomotion();
+        }
+        return true;
+    }
+
+    void APlayerCharacter::DispatchInputEvent(ELocomotionInputEvent Event, const FVector2D& Value)
+    {
+        switch (Event)
+        {
+        case ELocomotionInputEvent::Move: Move(FInputActionValue(Value)); break;
+        case ELocomotionInputEvent::Look: Look(FInputActionValue(Value)); break;
+        case ELocomotionInputEvent::RunPressed: RunPressed(); break;
+        case ELocomotionInputEvent::RunReleased: RunReleased(); break;
+        case ELocomotionInputEvent::Dance: Dance(); break;
+        case ELocomotionInputEvent::Jump: QueueJumpInput(); break;
+        case ELocomotionInputEvent::CrouchPressed: HandleCrouchOrSlidePressed(); break;
+        case ELocomotionInputEvent::CrouchReleased: HandleCrouchReleased(); break;
+        case ELocomotionInputEvent::Prone: ToggleProne(); break;
+        default: break;
+        }
+    }
+
+    void APlayerCharacter::ReplayInputFrame(float& InOutDeltaTime)
+    {
+        bDispatchingReplayInput = true;
+        while (const FLocomotionInputRecord* Record = InputReplay->NextEvent(InOutDeltaTime))
         {
-            if (CanCrouchUpFromProne())
+            DispatchInputEvent(Record->GetEvent(), FVector2D(Record->X, Record->Y));
+        }
+        bDispatchingReplayInput = false;
+
+        ReplayRecordedSeconds += InOutDeltaTime;
+
+        // The engine picks the delta time at the start of a frame, so queue the next recorded one now
+        if (bReplayFastForward)
+        {
+            const float NextDeltaTime = InputReplay->PeekNextFrameDeltaTime();
+            if (NextDeltaTime > 0.f)
             {
-                float OldHeight = Capsule->GetUnscaledCapsuleHalfHeight();
-                float NewHeight = CrouchCapsuleHalfHeight;
-                float Delta = NewHeight - OldHeight;
-                
-                FVector UpOffset(0.f, 0.f, 2.0f);
-                FHitResult Hit;
-                AddActorWorldOffset(UpOffset, true, &Hit);
-                
-                FVector DownOffset(0.f, 0.f, -Delta * 0.95f + CustomCapsuleCrouchOffset);
-                AddActorWorldOffset(DownOffset, true, &Hit);
-
-                Capsule->SetCapsuleHalfHeight(NewHeight, true);
-                PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -NewHeight));
-
-                bIsProning = false;
-                bIsCrouching = true;
-                bIsInProneTransition = true;
-                GetCharacterMovement()->MaxWalkSpeed = CrouchSpeed;
+                FApp::SetFixedDeltaTime(NextDeltaTime);
             }
         }
-        else if (bIsCrouching)
+
+        // Events after the last frame marker never reached a tick, and would leave the fixed step on with nothing to play
+        if (InputReplay->IsFinished() || InputReplay->PeekNextFrameDeltaTime() <= 0.f)
         {
-            float OldHeight = Capsule->GetUnscaledCapsuleHalfHeight();
-            float NewHeight = ProneCapsuleHalfHeight;
-            float Delta = OldHeight - NewHeight;
-            
-            FVector DownOffset(0.f, 0.f, Delta * 0.95f + CustomCapsuleProneOffset);
-            FHitResult Hit;
-            AddActorWorldOffset(DownOffset, true, &Hit);
+            StopInputReplay();
+        }
+    }
+
+    void APlayerCharacter::StartInputRecording(const FString& Filename)
+    {
+        StopInputReplay();
+        StopInputRecording();
 
-            Capsule->SetCapsuleHalfHeight(NewHeight, true);
-            PlayerMesh->SetRelativeLocation(FVector(0.f, 0.f, -NewHeight));
+        TUniquePtr<FLocomotionInputRecorder> Recorder = MakeUnique<FLocomotionInputRecorder>();
+        if (Recorder->Open(Filename, *this))
+        {
+            UE_LOG(LogLocomotion, Log, TEXT("Recording input to %s"), *Filename);
+            InputRecorder = MoveTemp(Recorder);
 
-            bIsProning = true;
-            bIsInProneTransition = true;
-            GetCharacterMovement()->MaxWalkSpeed = ProneSpeed;
+            // A dormant character would not write its frame markers
+            WakeLocomotion();
         }
     }
 
+    void APlayerCharacter::StopInputRecording()
+    {
+        InputRecorder.Reset();
+    }
 
+    void APlayerCharacter::StartInputReplay(const FString& Filename, bool bFastForward, bool bExitWhenDone)
+    {
+        StopInputRecording();
+        StopInputReplay();
 
-    bool APlayerCharacter::CanStandUp() const
+        TUniquePtr<FLocomotionInputReplay> Replay = MakeUnique<FLocomotionInputReplay>();
+        if (!Replay->Open(Filename))
+            return;
+
+        // Without a frame the replay would never tick to its end, and a fast forward would fix the step at 0
+        if (Replay->PeekNextFrameDeltaTime() <= 0.f)
+        {
+            UE_LOG(LogLocomotion, Warning, TEXT("Input recording %s has no frames to replay"), *Filename);
+            return;
+        }
+
+        // Start from where the recording started
+        const FLocomotionInputRecordingHeader& Header = Replay->GetHeader();
+        SetActorLocationAndRotation(FVector(Header.Location[0], Header.Location[1], Header.Location[2]), FRotator(0.f, Header.ActorYaw, 0.f), false, nullptr, ETeleportType::TeleportPhysics);
+        GetCharacterMovement()->StopMovementImmediately();
+        if (Controller)
+        {
+            Controller->SetControlRotation(FRotator(Header.ControlPitch, Header.ControlYaw, 0.f));
+        }
+
+        InputReplay = MoveTemp(Replay);
+        bReplayFastForward = bFastForward;
+        bReplayExitWhenDone = bExitWhenDone;
+        ReplayStartSeconds = FPlatformTime::Seconds();
+        ReplayRecordedSeconds = 0.0;
+
+        // Fixed steps run as fast as the machine allows, and match the recorded frame times
+        if (bFastForward)
+        {
+            bReplayRestoreFixedTimeStep = FApp::UseFixedTimeStep();
+            ReplayRestoreFixedDeltaTime = FApp::GetFixedDeltaTime();
+            FApp::SetUseFixedTimeStep(true);
+            FApp::SetFixedDeltaTime(InputReplay->PeekNextFrameDeltaTime());
+        }
+
+        // The replay runs in the locomotion tick, a dormant character would hold the fixed step forever
+        WakeLocomotion();
+
+        UE_LOG(LogLocomotion, Log, TEXT("Replaying %s: %u frames, %u events%s"), *Filename, Header.NumFrames, Header.NumRecords, bFastForward ? TEXT(", fast forward") : TEXT(""));
+    }
+
+    void APlayerCharacter::StopInputReplay()
     {
-        FVector Start = GetActorLocation() + FVector(0.f, 0.f, CrouchCapsuleHalfHeight);
-        float CheckDistance = (StandCapsuleHalfHeight - CrouchCapsuleHalfHeight) - CeilingCheckOffset;
-        FVector End = Start + FVector(0.f, 0.f, CheckDistance);
-        float Radius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+        if (!InputReplay)
+            return;
 
-        FCollisionQueryParams Params;
-        Params.AddIgnoredActor(this);
+        const double WallSeconds = FPlatformTime::Seconds() - ReplayStartSeconds;
+        UE_LOG(LogLocomotion, Log, TEXT("Replay finished: %u frames, %.2f s recorded in %.2f s (%.1fx real time)"),
+            InputReplay->GetNumFramesPlayed(), ReplayRecordedSeconds, WallSeconds, WallSeconds > 0.0 ? ReplayRecordedSeconds / WallSeconds : 0.0);
+
+        InputReplay.Reset();
+
+        if (bReplayFastForward)
+        {
+            FApp::SetUseFixedTimeStep(bReplayRestoreFixedTimeStep);
+            FApp::SetFixedDeltaTime(ReplayRestoreFixedDeltaTime);
+            bReplayFastForward = false;
+        }
+
+        if (bReplayExitWhenDone)
+        {
+            FPlatformMisc::RequestExit(false);
+        }
+    }
 
-        return !GetWorld()->SweepTestByChannel(Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Radius), Params);
+    FLocomotionSnapshot APlayerCharacter::CaptureLocomotionSnapshot() const
+    {
+        return LocomotionRollback::Capture(LocomotionState, GetCapsuleComponent()->GetUnscaledCapsuleHalfHeight());
     }
 
-    bool APlayerCharacter::CanCrouchUpFromProne() const
+    void APlayerCharacter::RestoreLocomotionSnapshot(const FLocomotionSnapshot& Snapshot)
     {
-        FVector Start = GetActorLocation() + FVector(0.f, 0.f, ProneCapsuleHalfHeight);
-        float CheckDistance = (CrouchCapsuleHalfHeight - ProneCapsuleHalfHeight) - CeilingCheckOffset;
-        FVector End = Start + FVector(0.f, 0.f, CheckDistance);
-        float Radius = GetCapsuleComponent()->GetScaledCapsuleRadius();
+        float CapsuleHalfHeight = 0.f;
+        LocomotionRollback::Restore(Snapshot, LocomotionState, CapsuleHalfHeight);
 
-        FCollisionQueryParams Params;
-        Params.AddIgnoredActor(this);
+        // Resize in place with the snapshot's capsule, the walk speed follows the restored stance
+        FLocomotionStanceChange Change = Locomotion::MakeStanceChange(GetLocomotionSettings(), LocomotionState.Stance);
+        Change.CapsuleHalfHeight = CapsuleHalfHeight;
+        Change.MeshOffsetZ = -CapsuleHalfHeight;
+        Change.bSetMaxWalkSpeed = Locomotion::ResolveMaxWalkSpeed(LocomotionState, GetLocomotionSettings(), LocomotionState.MovementInput.Y, Change.MaxWalkSpeed);
+        ApplyStanceChange(Change);
 
-        return !GetWorld()->SweepTestByChannel(Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(Radius), Params);
+        if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
+        {
+            if (LocomotionState.IsSliding())
+                Movement->StartSlideMode();
+            else
+                Movement->StopSlideMode();
+        }
+
+        // The next rollback frame starts from the restored state
+        bRollbackFrameStarted = false;
+
+        WakeLocomotion();
+        PublishAnimSnapshot();
     }
 
-    void APlayerCharacter::StartProneTransition()
+    void APlayerCharacter::StartRollbackRecording()
     {
-        bIsInProneTransition = true;
+        if (!RollbackBuffer)
+        {
+            RollbackBuffer = MakeUnique<FLocomotionRollbackBuffer>();
+        }
+        RollbackBuffer->Reset();
+        RollbackFrame = 0;
+        bRollbackFrameStarted = false;
     }
 
-    void APlayerCharacter::EndProneTransition()
+    void APlayerCharacter::StopRollbackRecording()
+    {
+        RollbackBuffer.Reset();
+        bRollbackFrameStarted = false;
+    }
+
+    void APlayerCharacter::ResetLocomotion()
+    {
+        StopInputRecording();
+        StopInputReplay();
+        StopRollbackRecording();
+
+        LocomotionState = FLocomotionState();
+        LocomotionTickAccumulator = 0.f;
+        IdleSeconds = 0.f;
+        bHasCachedClearance = false;
+        GroundProbe.Reset();
+
+        // Standing capsule, mesh offset and walk speed
+        ApplyStanceChange(Locomotion::MakeStanceChange(GetLocomotionSettings(), LocomotionState.Stance));
+
+        if (ULocomotionMovementComponent* Movement = GetLocomotionMovement())
+            Movement->ResetLocomotionMovement();
+
+        PublishAnimSnapshot();
+    }
+
+    bool APlayerCharacter::RewindCapsule(double ServerTime, FVector& OutLocation, float& OutHalfHeight) const
     {
-        bIsInProneTransition = false;
+        const ULocomotionMovementComponent* Movement = GetLocomotionMovement();
+        return Movement && Movement->GetCapsuleHistory().Rewind(ServerTime, OutLocation, OutHalfHeight);
     }
 
     void APlayerCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
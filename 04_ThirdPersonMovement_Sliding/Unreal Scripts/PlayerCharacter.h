@@ -8,20 +8,41 @@
 #include "InputActionValue.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/SpringArmComponent.h"
+#include "LocomotionCore.h"
+#include "LocomotionAnimSnapshot.h"
+#include "LocomotionFrameContext.h"
+#include "LocomotionGroundInfo.h"
+#include "LocomotionGroundProbe.h"
+#include "LocomotionInputRecording.h"
+#include "LocomotionMovementComponent.h"
+#include "LocomotionNotifyReceiver.h"
+#include "LocomotionRollback.h"
+#include "LocomotionTuning.h"
+#include <atomic>
 #include "PlayerCharacter.generated.h"
 
 UCLASS()
-class MECHANICS_TEST_LVN_API APlayerCharacter : public ACharacter
+class MECHANICS_TEST_LVN_API APlayerCharacter : public ACharacter, public ILocomotionNotifyReceiver
 {
 	GENERATED_BODY()
 
 public:
-	APlayerCharacter();
+	APlayerCharacter(const FObjectInitializer& ObjectInitializer);
+
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+	// Camera rig subobjects, skip both with DoNotCreateDefaultSubobject to create the rig on local possession
+	static const FName CameraBoomName;
+	static const FName FollowCameraName;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void PawnClientRestart() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 	virtual void Tick(float DeltaTime) override;
+	virtual void OnMovementModeChanged(EMovementMode PrevMovementMode, uint8 PreviousCustomMode = 0) override;
+	virtual void NotifyControllerChanged() override;
 	
 	// Player functions
 	void Move(const FInputActionValue& Value);
@@ -33,12 +54,110 @@ protected:
 	// Jump system functions
 	void QueueJumpInput();
 
-	bool bIsRunning = false;
-	bool bIsDancing = false;
-	bool bIsJumping = false;
-	bool bIsFlipping = false;
-	bool bIsCrouching = false;
-	bool bIsProning = false;
+	// Locomotion.PerfSuite bots drive the characters through DispatchInputEvent
+	friend class ULocomotionPerfSuite;
+
+	// Records input events, and ignores live input while a replay drives the character. Returns false when the handler should do nothing
+	bool RouteInput(ELocomotionInputEvent Event, const FVector2D& Value = FVector2D::ZeroVector);
+	void DispatchInputEvent(ELocomotionInputEvent Event, const FVector2D& Value);
+	void ReplayInputFrame(float& InOutDeltaTime);
+
+	TUniquePtr<FLocomotionInputRecorder> InputRecorder;
+	TUniquePtr<FLocomotionInputReplay> InputReplay;
+	bool bDispatchingReplayInput = false;
+	bool bReplayFastForward = false;
+	bool bReplayExitWhenDone = false;
+	bool bReplayRestoreFixedTimeStep = false;
+	double ReplayRestoreFixedDeltaTime = 0.0;
+	double ReplayStartSeconds = 0.0;
+	double ReplayRecordedSeconds = 0.0;
+
+	// Locomotion core glue, also driven by ULocomotionSubsystem when ticking in batch
+	friend class ULocomotionSubsystem;
+	void GatherLocomotionInput(float DeltaTime, FLocomotionTickInput& Input);
+
+	// Runs a button or notify event through Locomotion::HandleEvent with this frame's world answers, applies the result and records it for rollback
+	FLocomotionEventResult HandleLocomotionEvent(ELocomotionEvent Event, const FVector2D& Value = FVector2D::ZeroVector);
+
+	// Rollback recording. A frame starts with the first event or tick input after the previous tick, and is recorded once its tick is applied
+	void BeginRollbackFrame();
+	void EndRollbackFrame();
+	TUniquePtr<FLocomotionRollbackBuffer> RollbackBuffer;
+	FLocomotionSnapshot RollbackFrameStart;
+	FLocomotionFrameInput RollbackFrameInput;
+	uint32 RollbackFrame = 0;
+	bool bRollbackFrameStarted = false;
+
+	// Significance-driven tick LOD, set by ULocomotionSubsystem. 0 ticks every frame
+	void SetLocomotionTickInterval(float Interval);
+	// Batched pass: adds the frame time, returns the time to simulate once the interval has elapsed, 0 otherwise
+	float ConsumeLocomotionTickTime(float DeltaTime);
+	float LocomotionTickInterval = 0.f;
+	float LocomotionTickAccumulator = 0.f;
+
+	// Batched pass: the controller whose tick the pass waits for, and whether a Blueprint Tick event needs calling in place of the actor tick
+	TWeakObjectPtr<AController> BatchTickController;
+	bool bHasBlueprintTick = false;
+
+	// Dormant characters do not tick until WakeLocomotion(), see ULocomotionSubsystem::SetCharacterDormant
+	bool CanGoDormant() const;
+	// Adds a tick to the idle time, or clears it. True once the character has been idle for the grace period and may go dormant
+	bool UpdateIdleTime(bool bIdle, float DeltaTime);
+	bool bLocomotionDormant = false;
+	float IdleSeconds = 0.f;
+	void ApplyLocomotionOutput(const FLocomotionTickOutput& Output);
+	void DrawSlideDebug(const FLocomotionTickOutput& Output) const;
+
+	// Runs the slide movement mode against LocomotionState, and predicts it through saved moves
+	friend class ULocomotionMovementComponent;
+	friend class FSavedMove_Locomotion;
+	friend struct FLocomotionMoveResponseDataContainer;
+	// Server side: stance, run and a new jump queue from a client move's compressed flags
+	void ApplyMoveLocomotionFlags(ELocomotionStance Stance, bool bRunning, bool bQueueJump);
+	// Owning client on a move correction and simulated proxies: takes the server's stance and run flag without validation
+	void ApplyServerLocomotionFlags(ELocomotionStance Stance, bool bRunning);
+
+	// Server stance and run flag for simulated proxies, packed like the move flags. The movement component writes it on the server
+	UPROPERTY(ReplicatedUsing = OnRep_ReplicatedLocomotionFlags)
+	uint8 ReplicatedLocomotionFlags = 0;
+
+	UFUNCTION()
+	void OnRep_ReplicatedLocomotionFlags();
+	ULocomotionMovementComponent* GetLocomotionMovement() const { return Cast<ULocomotionMovementComponent>(GetCharacterMovement()); }
+	// Commits a stance change in one scoped move: the actor offset from one floor and clearance check, then the capsule and mesh
+	void ApplyStanceChange(const FLocomotionStanceChange& Change);
+	float SolveStanceOffsetZ(const FLocomotionStanceChange& Change) const;
+
+	// Slide, jump and stance state, driven by the engine-agnostic locomotion rules
+	FLocomotionState LocomotionState;
+	// Points into the shared tuning asset, or at LocomotionSettingsOverride when this character cannot use them as they are
+	const FLocomotionSettings* LocomotionSettings = nullptr;
+	TUniquePtr<FLocomotionSettings> LocomotionSettingsOverride;
+	const FLocomotionSettings& GetLocomotionSettings() const { return *LocomotionSettings; }
+
+	// Packed FLocomotionAnimSnapshot, written once per locomotion tick and read by animation worker threads
+	void PublishAnimSnapshot();
+	std::atomic<uint64> PackedAnimSnapshot { 0 };
+
+	// Derived values and queries shared by the tick and input handlers within one frame
+	friend struct FLocomotionFrameContext;
+	FLocomotionFrameContext& GetFrameContext() const;
+	mutable FLocomotionFrameContext FrameContext;
+
+	// Ground under the actor from the movement component floor, traced only while airborne
+	FLocomotionGroundInfo QueryGroundInfo(float MaxDistance) const;
+
+	// Pipelined airborne ground trace, see Locomotion.AsyncGroundProbes
+	FLocomotionGroundProbe GroundProbe;
+	static constexpr float GroundProbeDistance = 200.f;
+	static constexpr float SlideGroundProbeDistance = 150.f;
+
+	// Headroom from one sweep, reused until the capsule resizes or moves further than ClearanceCacheTolerance
+	const FLocomotionClearance& QueryClearance() const;
+	mutable FLocomotionClearance CachedClearance;
+	mutable FVector CachedClearanceLocation = FVector::ZeroVector;
+	mutable float CachedClearanceHalfHeight = 0.f;
+	mutable bool bHasCachedClearance = false;
 	
 	// Input properties
 	UPROPERTY(EditDefaultsOnly, Category = "Input")
@@ -65,169 +184,124 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = "Input")
 	UInputAction* ProneAction;
 
-	// Camera components and properties
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")
-	float SensitivityMultiplier;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")
-	float VerticalSensitivityMultiplier;
+	// Camera components
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera")
 	USpringArmComponent* CameraBoom;
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Camera")
 	UCameraComponent* FollowCamera;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Camera")
-	float CameraSpawnPitch;
-	float InitialCameraSpawnPitch;
-
-	// Movement properties
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
-	float RotationSpeed;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
-	float WalkSpeed;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
-	float SprintSpeed;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
-	float WalkableSlopeAngle;
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Movement")
-	float StepOffset;
-
-	// Jump General properties
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jumping")
-	float JumpForce = 1000.f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jumping")
-	float FlipJumpForce = 800.f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jumping")
-	float CustomAirControl = 1.5f;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jumping")
-	float CustomGravityScale = 2.f;
+	// Creates the camera rig when the class skipped it, called when a local player possesses the pawn
+	void EnsureCameraRig();
+	void ConfigureCameraRig();
 
-	// Jump Extra properties
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jumping")
-	float JumpBufferTime = 0.1f;
+	// Movement, camera and replication tuning, shared with every character using the same asset. Empty uses the ULocomotionTuning defaults
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Locomotion")
+	TObjectPtr<ULocomotionTuning> Tuning;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Jumping")
-	bool bAllowDoubleJump = true;
-
-	UPROPERTY(BlueprintReadOnly, Category = "Jumping")
-	bool bJumpInputQueued = false;
-
-	UPROPERTY(BlueprintReadOnly, Category = "Jumping")
-	bool bJumpPending = false;
-
-	UPROPERTY(BlueprintReadOnly, Category = "Jumping")
-	int32 JumpCount = 0;
-
-	float JumpBufferTimer = 0.1f;
-
-	// Crouch properties
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crouch")
-	float CrouchSpeed = 200.f;
-	
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crouch")
-	float CrouchCapsuleHalfHeight = 44.f;
+	// Applies the rate for the current state, a raise replicates straight away. The movement component calls it
+	// after every move, so it follows the velocity while the locomotion tick is dormant
+	void UpdateNetUpdateRate();
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crouch")
-	float StandCapsuleHalfHeight = 88.f;
+	// Tier the rate was last written for, the rate is only rewritten when the tier changes. None forces the next write
+	enum class ENetUpdateTier : uint8 { None, Idle, Moving, Action };
+	ENetUpdateTier NetUpdateTier = ENetUpdateTier::None;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Crouch")
-	float CustomCapsuleCrouchOffset = -40.f;
 
-	// Slide properties
-	bool bIsSliding = false;
-	FVector SlideVelocity = FVector::ZeroVector;
-	float SlideFallTimer = 0.f;
-	float SlideStartTimer = 0.f;
-	
-
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float GroundCheckDistance = 600.f;
-
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float MaxSlideSpeed = 3000.f;
-
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float SlideAirThreshold = 500.f;
-
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float SlideSpeed = 600.f;
-
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float MinSlideSpeed = 200.f;
-
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float SlideFriction = 2.25f;
+public:
 
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float SlideFallGraceTime = 0.5f;
+	// Notify methods, reached through UAnimNotify_Locomotion events
+	virtual void HandleLocomotionNotify(ELocomotionNotifyEvent Event) override;
+	void ApplyJumpForce(); // Called when Jumping Animation leaves the ground
+	void TriggerFlip(); // Called at the start of Flip Animation
+	void EndFlip(); // Called at the end of Flip Animation
+	void HandleCrouchReleased();
+	void HandleCrouchOrSlidePressed();
+	void ToggleProne();
+	void ExitSlide();
+	float GetGroundDistance() const;
 
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float RampBoostSpeed  = 1500.f;
+	// Drops the tick LOD back to full rate, slide and jump starts must not wait for the next significance update
+	void WakeLocomotionTick();
 
-	UPROPERTY(EditAnywhere, Category = "Sliding")
-	float FlatSlideBoost = 300.f;
+	// Resumes ticking a dormant character. Input events, anim notifies and movement mode changes call this
+	void WakeLocomotion();
+	bool IsLocomotionDormant() const { return bLocomotionDormant; }
 
-	//Prone properties
+	// Input capture and deterministic replay, see Locomotion.RecordInput / Locomotion.ReplayInput
+	void StartInputRecording(const FString& Filename);
+	void StopInputRecording();
+	void StartInputReplay(const FString& Filename, bool bFastForward, bool bExitWhenDone);
+	void StopInputReplay();
+	bool IsReplayingInput() const { return InputReplay.IsValid(); }
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prone")
-	float ProneCapsuleHalfHeight = 40.f;
+	// Rollback: locomotion state and capsule height as one 48-byte snapshot. Restoring resizes the capsule and
+	// moves the slide mode to match, without sweeping the actor. Resimulate with FLocomotionRollbackBuffer
+	FLocomotionSnapshot CaptureLocomotionSnapshot() const;
+	void RestoreLocomotionSnapshot(const FLocomotionSnapshot& Snapshot);
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prone")
-	float CeilingCheckOffset = 5.f;
+	// Records every locomotion tick into a FLocomotionRollbackBuffer with its events and world answers, frames count locomotion
+	// ticks. Resimulating replays the rules only, a slide run by the movement mode is kept as the snapshots recorded it
+	void StartRollbackRecording();
+	void StopRollbackRecording();
+	FLocomotionRollbackBuffer* GetRollbackBuffer() const { return RollbackBuffer.Get(); }
+	uint32 GetNextRollbackFrame() const { return RollbackFrame; }
 
-	UPROPERTY(BlueprintReadOnly, Category = "Prone")
-	bool bIsInProneTransition = false;
+	// Back to a freshly spawned character: standing capsule and mesh offset, no jump, slide or input state. See ULocomotionCharacterPool
+	void ResetLocomotion();
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prone")
-	float ProneSpeed = 125.f;
+	// Lag compensation on the server: capsule center and scaled half-height at ServerTime, within the last 500 ms
+	bool RewindCapsule(double ServerTime, FVector& OutLocation, float& OutHalfHeight) const;
 
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Prone")
-	float CustomCapsuleProneOffset = -20.f;
+	// Points the locomotion core at the tuning asset and applies its movement component values
+	UFUNCTION(BlueprintCallable, Category="Movement")
+	void RefreshLocomotionSettings();
 
-	
-private:
-	FVector2D MovementInput;
+	// Switches to another shared tuning asset, nullptr for the defaults
+	UFUNCTION(BlueprintCallable, Category="Movement")
+	void SetTuning(ULocomotionTuning* NewTuning);
 
-public:
+	const ULocomotionTuning* GetTuning() const { return Tuning ? Tuning.Get() : GetDefault<ULocomotionTuning>(); }
 
-	// Notify methods
-	void ApplyJumpForce(); // Called when Jumping Animation leaves the ground
-	void TriggerFlip(); // Called at the start of Flip Animation
-	void EndFlip(); // Called at the end of Flip Animation
-	void HandleCrouchReleased();
-	void HandleCrouchOrSlidePressed();
-	void ToggleProne();
-	void TryStartSlide();
-	void ExitSlide();
-	float GetGroundDistance() const;
+	// Locomotion state as of the last tick, safe to call from animation worker threads. See ULocomotionAnimInstance
+	FLocomotionAnimSnapshot GetAnimSnapshot() const { return FLocomotionAnimSnapshot::Unpack(PackedAnimSnapshot.load(std::memory_order_acquire)); }
 
-	// Getters for movement input and states
+	// Getters for movement input and states, polled on the game thread. Prefer ULocomotionAnimInstance in animation blueprints
 	UFUNCTION(BlueprintCallable, Category="Movement")
-	float GetForwardInput() const { return MovementInput.Y; }
+	float GetForwardInput() const { return LocomotionState.MovementInput.Y; }
 
 	UFUNCTION(BlueprintCallable, Category="Movement")
-	bool IsRunning() const { return bIsRunning; }
+	bool IsRunning() const { return LocomotionState.bIsRunning; }
 
 	UFUNCTION(BlueprintCallable, Category="Movement")
-	bool IsDancing() const { return bIsDancing; }
+	bool IsDancing() const { return LocomotionState.IsDancing(); }
+
+	UFUNCTION(BlueprintCallable, Category="Jumping")
+	bool IsJumping() const { return LocomotionState.IsJumping(); }
 
 	UFUNCTION(BlueprintCallable, Category="Jumping")
-	bool IsJumping() const { return bIsJumping; }
+	bool IsFlipping() const { return LocomotionState.IsFlipping(); }
 
 	UFUNCTION(BlueprintCallable, Category="Jumping")
-	bool IsFlipping() const { return bIsFlipping; }
+	bool IsJumpInputQueued() const { return LocomotionState.bJumpInputQueued; }
+
+	UFUNCTION(BlueprintCallable, Category="Jumping")
+	bool IsJumpPending() const { return LocomotionState.bJumpPending; }
+
+	UFUNCTION(BlueprintCallable, Category="Jumping")
+	int32 GetJumpCount() const { return LocomotionState.JumpCount; }
 
 	UFUNCTION(BlueprintCallable, Category="Sliding")
-	bool IsSliding() const { return bIsSliding; }
+	bool IsSliding() const { return LocomotionState.IsSliding(); }
 	
 	UFUNCTION(BlueprintCallable, Category="Crouching")
-	bool IsPlayerCrouching() const { return bIsCrouching; }
+	bool IsPlayerCrouching() const { return LocomotionState.IsCrouching(); }
+
+	UFUNCTION(BlueprintCallable, Category="Proning")
+	bool IsPlayerProning() const { return LocomotionState.IsProning(); }
 
 	UFUNCTION(BlueprintCallable, Category="Proning")
-	bool IsPlayerProning() const { return bIsProning; }
+	bool IsInProneTransition() const { return LocomotionState.IsInProneTransition(); }
 
 	UFUNCTION(BlueprintCallable, Category = "Crouch")
 	bool CanStandUp() const;